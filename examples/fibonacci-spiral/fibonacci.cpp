@@ -73,13 +73,6 @@ constexpr SDL_FRect next_subframe(SDL_FRect& guide, std::uint32_t k)
     return rect;
 }
 
-/** Draw a colored rect to a renderer */
-inline void fill_rect(SDL_Renderer* renderer, const SDL_FRect& rect, const SDL_Color& color)
-{
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderFillRect(renderer, &rect);
-}
-
 /** Generate the fibonacci spiral sequence
  *
  * \param spiral The settings that describe how to draw the spiral
@@ -111,28 +104,34 @@ inline void draw_spiral(SDL_Renderer* renderer, const spiral_data& spiral)
     SDL_FRect render_frame{ 0.f, 0.f, static_cast<float>(output_size.x),
                                       static_cast<float>(output_size.y) };
 
-    // render each subframe with the next color on the gradient
+    // render each subframe with the next color on the gradient, all in one batch
     auto colored_rect_sequence = views::iota(0u, spiral.num_frames)
                                | views::transform(generate_sequence(spiral, render_frame));
+    ion::quad_batch batch;
     for (const auto& [rect, color] : colored_rect_sequence)
     {
-        fill_rect(renderer, rect, color);
+        batch.push(rect, color, SDL_BLENDMODE_NONE);
     }
+    batch.flush(renderer);
 }
 
 int main(int argc, char * argv[])
 {
+    if (not ion::session::from_args(argc, argv)) { return EXIT_FAILURE; }
+
     const auto editor = ion::editor::initialize();
     if (not editor) { return EXIT_FAILURE; }
 
     // load the spiral settings and draw it to the whole window
     const auto spiral = ion::read_yaml<spiral_data>(ion::editor_settings::load_setting("spiral"));
 
-    draw_spiral(editor->renderer.get(), spiral);
-    SDL_RenderPresent(editor->renderer.get());
+    // the spiral never changes, so it's only drawn again when the window needs it
+    auto loop = ion::run_loop::on_demand();
     while (not editor->has_quit())
     {
-        ion::sdl_events::poll();
+        if (not loop.poll()) { continue; }
+        draw_spiral(editor->renderer.get(), spiral);
+        SDL_RenderPresent(editor->renderer.get());
     }
     return EXIT_SUCCESS;
 }
@@ -3,12 +3,20 @@
 
 int main(int argc, char * argv[])
 {
+    if (not ion::session::from_args(argc, argv)) { return EXIT_FAILURE; }
+
     const auto editor = ion::editor::initialize();
     if (not editor) { return EXIT_FAILURE; }
 
+    // nothing but quit is listened to, so keep everything else out of the event queue - the
+    // on demand loop observes the window events it redraws on, so those are still queued
+    ion::sdl_events::filter_unobserved(true);
+
+    // there's nothing to draw, so sleep until something happens
+    auto loop = ion::run_loop::on_demand();
     while (not editor->has_quit())
     {
-        ion::sdl_events::poll();
+        loop.poll();
     }
     return EXIT_SUCCESS;
 }
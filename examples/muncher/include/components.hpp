@@ -15,6 +15,11 @@ struct bbox {
     }
 };
 
+// where a bbox was before the last simulation step, for interpolating between steps
+struct previous_bbox {
+    float x, y, size;
+};
+
 struct velocity {
     float x, y;
 };
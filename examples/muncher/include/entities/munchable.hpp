@@ -34,12 +34,13 @@ public:
            player const & player_settings, engine_t rng) const;
 
     /**
-     * Determine if a munchable entity should be created
+     * Determine how long to wait until the next munchable entity is created
      *
-     * \param dt the time since the last frame in seconds
      * \param rng the random number generator
+     *
+     * \return the time to wait in seconds
      */
-    bool should_munch(float dt, engine_t & rng) const;
+    float munch_delay(engine_t & rng) const;
 private:
     std::vector<component::color> _colors;
 
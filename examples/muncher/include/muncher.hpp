@@ -7,8 +7,19 @@
 #include <entt/entity/registry.hpp>
 #include <entt/signal/sigh.hpp>
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <thread>
+#include <vector>
 #include <ion/input/axis.hpp>
+#include <ion/engine/frame_pipeline.hpp>
+#include <ion/engine/quad_batch.hpp>
+#include <ion/time/fixed_step.hpp>
+#include <ion/time/telemetry.hpp>
+#include <ion/time/timer_wheel.hpp>
+#include "systems/render.hpp"
 
 class event_sink
 {
@@ -47,16 +58,63 @@ public:
      */
     void update(float delta_time);
 
+    /**
+     * Start simulating on a worker thread, so that update_pipelined can render one frame
+     * while the next one is simulated
+     *
+     * \param bounded_latency whether to keep the simulation from getting more than a frame
+     *                        ahead of what's on screen, rather than skipping frames to show
+     *                        the newest one
+     */
+    void start_pipeline(bool bounded_latency = true);
+
+    /**
+     * Run the game with the pipeline, handing this frame's input to the simulation thread
+     * and rendering the last frame it simulated
+     */
+    void update_pipelined(float delta_time);
+
+    /**
+     * Stop the simulation thread
+     */
+    void stop_pipeline();
+
     /**
      * Reset the game
      */
     void reset();
+
+    /**
+     * Set how many fixed simulation steps run each second, independent of the frame rate
+     */
+    void step_rate(double hz);
 private:
+    // simulate a frame's worth of fixed steps
+    void simulate(float delta_time, ion::input::axis2d const & input, SDL_FRect const & bounds);
+    void step(float step_size, ion::input::axis2d const & input, SDL_FRect const & bounds);
+    void respawn_player(SDL_FRect const & bounds);
+    void run_simulation(std::stop_token stop);
+
+    // what happens when a timer is due
+    enum class timed_event {
+        spawn_munchable
+    };
+
+    // what the simulation thread needs from the main thread to simulate a frame
+    struct frame_input {
+        float delta_time;
+        float x, y;
+        SDL_FRect bounds;
+        bool reset;
+    };
+
     // events and input
     ion::input::keyboard_axis _input;
 
     // entt setup
     engine_t _rng;
+    // where every entity is for rendering - declared before the registry so it outlives it
+    systems::bounds_index _bounds{ 64.f };
     entt::registry _entities;
 
     // entity prefabs
@@ -65,6 +123,31 @@ private:
 
     // entity references
     entt::entity _player = entt::null;
+
+    // simulation runs in fixed steps, and rendering interpolates between the last two
+    ion::fixed_step_loop _steps{ 120. };
+
+    // timed events run on simulation time, rather than being checked for every step
+    ion::timer_wheel<timed_event> _timers;
+    std::vector<timed_event> _due_events;
+
+    // how long each frame's simulation and rendering take
+    ion::histogram & _simulate_times = ion::telemetry::scope("simulate");
+    ion::histogram & _render_times = ion::telemetry::scope("render");
+
+    // rendering
+    ion::quad_batch _quads;
+    systems::render_snapshot _frame;
+
+    // pipelining - the main thread owns everything but the entities while the pipeline runs
+    std::unique_ptr<ion::frame_pipeline<systems::render_snapshot>> _frames;
+    bool _bounded_latency = true;
+    bool _is_frame_in_flight = false;
+    bool _reset_requested = false;
+    std::mutex _input_mutex;
+    std::condition_variable_any _input_ready;
+    std::vector<frame_input> _inputs;
+    std::jthread _simulation;
 };
 
 muncher & get_game();
@@ -21,6 +21,16 @@ namespace systems {
 void accelerate_player(entt::registry & entities, entt::entity player,
                        ion::input::axis2d const & input, float dt);
 
+/**
+ * Remember where every bounding box is before a simulation step
+ *
+ * \param entities the registry to remember bounding boxes in
+ *
+ * Rendering interpolates from where entities were to where they are, so this should be
+ * called before each fixed step.
+ */
+void store_previous_bounds(entt::registry & entities);
+
 /**
  * Move all game entities according to their velocity
  *
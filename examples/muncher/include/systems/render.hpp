@@ -1,30 +1,125 @@
 #pragma once
 #include <entt/entity/registry.hpp>
+#include <algorithm>
+#include <vector>
 #include <SDL3/SDL_render.h>
+#include <ion/containers/spatial_grid.hpp>
+#include <ion/engine/quad_batch.hpp>
 #include "components.hpp"
 
 namespace systems {
 
-void render_colored_box(SDL_Renderer * renderer, const component::bbox& box,
-                                                 const component::color & color);
+/**
+ * A spatial index of where every bounding box is, so rendering only looks at what's in view
+ */
+using bounds_index = ion::spatial_grid<entt::entity>;
 
-inline void render(SDL_Renderer * renderer, entt::registry & registry)
+/**
+ * Add an entity's bounding box to the index, or move it there - connect this to the bbox
+ * construct and update signals
+ *
+ * Boxes that stay within the same cells are updated in place, so this is cheap for things
+ * that move a little every step.
+ */
+inline void index_bounds(bounds_index & index, entt::registry & registry, entt::entity entity)
+{
+    auto const & box = registry.get<component::bbox>(entity);
+    index.insert(entity, { box.x, box.y, box.size, box.size });
+}
+
+/**
+ * Remove an entity from the index - connect this to the bbox destroy signal
+ */
+inline void forget_bounds(bounds_index & index, entt::registry &, entt::entity entity)
+{
+    index.erase(entity);
+}
+
+/**
+ * Keep an index in sync with the bounding boxes in a registry
+ *
+ * \param registry the registry to index
+ * \param index the index to keep up to date - it has to outlive the registry
+ *
+ * Only the boxes that are added, changed or removed are reindexed, so boxes have to be
+ * changed through the registry, with patch or replace, for the index to see it.
+ */
+inline void track_bounds(entt::registry & registry, bounds_index & index)
+{
+    registry.on_construct<component::bbox>().connect<&index_bounds>(index);
+    registry.on_update<component::bbox>().connect<&index_bounds>(index);
+    registry.on_destroy<component::bbox>().connect<&forget_bounds>(index);
+}
+
+/**
+ * What the renderer needs to draw an entity
+ */
+struct render_quad {
+    SDL_FRect dst;
+    SDL_Color color;
+    // which entity the quad is of, which orders the quads in a snapshot
+    entt::entity entity;
+};
+
+/**
+ * Everything to draw in a frame, so that rendering doesn't need to read the registry
+ */
+using render_snapshot = std::vector<render_quad>;
+
+/**
+ * Collect what to draw of every indexed entity that's in view
+ *
+ * The quads are sorted by entity, so the draw order doesn't change as entities move
+ * between the index's cells.
+ *
+ * \param registry the registry the entities are in
+ * \param index where the entities are
+ * \param view the region of the world to draw
+ * \param snapshot the snapshot to fill, replacing what was in it
+ * \param alpha how far to interpolate from where entities were before the last step to
+ *              where they are now
+ */
+inline void extract_render(entt::registry const & registry, bounds_index const & index,
+                           SDL_FRect const & view, render_snapshot & snapshot, float alpha = 1.f)
+{
+    snapshot.clear();
+    index.query({ view.x, view.y, view.w, view.h }, [&](entt::entity const entity) {
+        if (not registry.all_of<component::bbox, component::color>(entity)) {
+            return;
+        }
+        auto const & [box, color] = registry.get<component::bbox, component::color>(entity);
+        SDL_FRect dst = static_cast<SDL_FRect>(box);
+        if (auto const * previous = registry.try_get<component::previous_bbox>(entity)) {
+            dst.x = previous->x + (box.x - previous->x)*alpha;
+            dst.y = previous->y + (box.y - previous->y)*alpha;
+            dst.w = dst.h = previous->size + (box.size - previous->size)*alpha;
+        }
+        dst.x -= view.x;
+        dst.y -= view.y;
+        snapshot.push_back({ dst, SDL_Color{ color.r, color.g, color.b, 0xff }, entity });
+    });
+    std::ranges::sort(snapshot, {}, &render_quad::entity);
+}
+
+/**
+ * Draw a frame
+ *
+ * \param renderer the renderer to draw with
+ * \param batch the batch to draw quads with
+ * \param snapshot what to draw
+ */
+inline void render(SDL_Renderer * renderer, ion::quad_batch & batch, render_snapshot const & snapshot)
 {
     // clear the screen with white
     SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
     SDL_RenderClear(renderer);
 
-    // render the game objects
-    registry.view<component::bbox, component::color>()
-            .each([&](const auto & box, const auto & color) { render_colored_box(renderer, box, color); });
+    // render the game objects in one batch - they're all opaque, so there's nothing to blend
+    batch.reserve(snapshot.size(), nullptr, SDL_BLENDMODE_NONE);
+    for (auto const & quad : snapshot) {
+        batch.push(quad.dst, quad.color, SDL_BLENDMODE_NONE);
+    }
+    batch.flush(renderer);
     SDL_RenderPresent(renderer);
 }
-
-inline void render_colored_box(SDL_Renderer * renderer, const component::bbox& box,
-                                                        const component::color & color)
-{
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 0xff);
-    const auto render_rect = static_cast<SDL_FRect>(box);
-    SDL_RenderFillRect(renderer, &render_rect);
-}
 }
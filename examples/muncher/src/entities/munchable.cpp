@@ -58,14 +58,12 @@ munchable::create(entt::registry & entities, entt::entity player_id, SDL_FRect b
     return munchable_id;
 }
 
-bool munchable::should_munch(float dt, engine_t & rng) const
+float munchable::munch_delay(engine_t & rng) const
 {
-    // convert dt to milliseconds
-    dt *= 1000.f;
-
-    // coin flip distribution determine whether to munch
-    std::binomial_distribution is_munch_time{true, _munch_time_likelihood*dt};
-    return is_munch_time(rng);
+    // munchables are as likely to be created at any millisecond, so the time between them is
+    // exponentially distributed - convert the likelihood to a rate per second
+    std::exponential_distribution time_until_munch{_munch_time_likelihood*1000.f};
+    return time_until_munch(rng);
 }
 
 component::bbox &
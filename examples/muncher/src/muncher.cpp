@@ -10,12 +10,36 @@
 #include <entt/entity/registry.hpp>
 #include <SDL3/SDL_keycode.h>
 #include <random>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
 
 #include <ion/engine.hpp>
 #include <ion/editor.hpp>
 #include <ion/time.hpp>
 
 ion::editor * GEditor = nullptr;
+
+namespace {
+// an input axis with the values it had when it was sampled
+class sampled_axis : public ion::input::axis2d {
+public:
+    sampled_axis(float x, float y) : _x{x}, _y{y} {}
+
+    float x() const override { return _x; }
+    float y() const override { return _y; }
+private:
+    float _x, _y;
+};
+
+SDL_FRect window_bounds()
+{
+    SDL_Point window_size;
+    SDL_GetWindowSize(GEditor->window.get(), &window_size.x, &window_size.y);
+    return { 0.f, 0.f, static_cast<float>(window_size.x), static_cast<float>(window_size.y) };
+}
+}
+
 muncher & get_game()
 {
     static muncher game;
@@ -24,19 +48,63 @@ muncher & get_game()
 
 int main(int argc, char * argv[])
 {
+    if (not ion::session::from_args(argc, argv)) { return EXIT_FAILURE; }
+
+    // "--pipelined" simulates on a worker thread with bounded latency, and
+    // "--pipelined-latest" always shows the newest frame instead. "--sim-hz <rate>" sets the
+    // fixed simulation rate, and "--render-hz <rate>" caps rendering instead of using vsync.
+    // "--telemetry <path>" exports frame, simulation and render times as csv or json on exit.
+    // "--time-scale <scale>" speeds up or slows down time, and "--virtual-time" runs frames as
+    // fast as they can go, each one a frame's worth of game time - like for soak tests
+    bool is_pipelined = false, bounded_latency = true, is_virtual_time = false;
+    double sim_hz = 120., render_hz = 0., time_scale = 1.;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{ argv[i] };
+        if (arg == "--pipelined") { is_pipelined = true; }
+        if (arg == "--pipelined-latest") { is_pipelined = true; bounded_latency = false; }
+        if (arg == "--sim-hz" and i + 1 < argc) { sim_hz = std::atof(argv[++i]); }
+        if (arg == "--render-hz" and i + 1 < argc) { render_hz = std::atof(argv[++i]); }
+        if (arg == "--telemetry" and i + 1 < argc) { ion::telemetry::export_at_exit(argv[++i]); }
+        if (arg == "--time-scale" and i + 1 < argc) { time_scale = std::atof(argv[++i]); }
+        if (arg == "--virtual-time") { is_virtual_time = true; }
+    }
+
+    // time sources have to outlive the clock and loop that use them
+    ion::virtual_time virtual_time;
+    ion::scaled_time scaled_time{ ion::time_source::real(), time_scale };
+    if (is_virtual_time) { ion::time_source::use(&virtual_time); }
+    else if (time_scale != 1.) { ion::time_source::use(&scaled_time); }
+
     auto editor = ion::editor::initialize();
     if (not editor) { return EXIT_FAILURE; }
     GEditor = editor.get();
 
     auto & game = get_game();
+    game.step_rate(sim_hz);
     game.reset();
+    if (is_pipelined) { game.start_pipeline(bounded_latency); }
+
+    // vsync paces frames in real time, so virtual time needs a capped loop to move forward
+    if (is_virtual_time and render_hz <= 0.) { render_hz = 60.; }
+    auto loop = render_hz > 0.? ion::run_loop::capped(render_hz)
+                              : ion::run_loop::vsync(editor->renderer.get());
     ion::clock clock;
+    clock.record_into(&ion::telemetry::scope("frame"));
     while (not editor->has_quit())
     {
-        const float delta_time = clock.tick();
-        ion::sdl_events::poll();
-        game.update(delta_time);
+        loop.wait();
+        const float delta_time = ion::session::poll(clock.tick());
+        if (is_pipelined) { game.update_pipelined(delta_time); }
+        else { game.update(delta_time); }
     }
+    game.stop_pipeline();
+    ion::time_source::use(nullptr);
+
+    // report how the last few seconds of frames were paced
+    const ion::frame_summary frames = clock.frames().summary();
+    SDL_Log("frame times (ms) min %.3f, mean %.3f, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f\n",
+            frames.min*1e3, frames.mean*1e3, frames.p50*1e3, frames.p95*1e3, frames.p99*1e3,
+            frames.max*1e3);
     return EXIT_SUCCESS;
 }
 
@@ -46,50 +114,164 @@ muncher::muncher()
     : // create a wasd keyboard input axis
       _input(SDLK_D, SDLK_A, SDLK_W, SDLK_S),
 
-      // initialize the random engine with a pseudo-random seed
-      _rng{std::random_device{}()}
+      // initialize the random engine with a seed that's recorded with the session
+      _rng{ion::session::seed()}
 {
     // check if sdl resources initialized properly
     ion::sdl_events::on_key_up().connect<&reset_game>();
+
+    // keep the spatial index in sync as entities are added, moved and destroyed
+    systems::track_bounds(_entities, _bounds);
+
+    // wait for the first munchable
+    _timers.schedule(_munchable_settings.munch_delay(_rng), timed_event::spawn_munchable);
 }
 
 void muncher::update(float delta_time)
 {
-    SDL_Point window_size;
-    SDL_GetWindowSize(GEditor->window.get(), &window_size.x, &window_size.y);
-    const SDL_FRect bounds{ 0.f, 0.f, static_cast<float>(window_size.x),
-                                      static_cast<float>(window_size.y) };
-    // create a new munchable entity if it's time to
-    if (_munchable_settings.should_munch(delta_time, _rng)) {
+    const SDL_FRect bounds = window_bounds();
+    simulate(delta_time, _input, bounds);
+
+    // render only what's in view - the world is the window, so this only culls the
+    // munchables that are on their way in or out past its edges
+    systems::extract_render(_entities, _bounds, bounds, _frame, _steps.alpha());
+
+    ion::scoped_timer const timer{ _render_times };
+    systems::render(GEditor->renderer.get(), _quads, _frame);
+}
+
+void muncher::simulate(float delta_time, ion::input::axis2d const & input,
+                       SDL_FRect const & bounds)
+{
+    ion::scoped_timer const timer{ _simulate_times };
+    _steps.run(delta_time, [&](double const step_size) {
+        step(static_cast<float>(step_size), input, bounds);
+    });
+}
+
+void muncher::step(float delta_time, ion::input::axis2d const & input,
+                   SDL_FRect const & bounds)
+{
+    systems::store_previous_bounds(_entities);
 
-        _munchable_settings.create(_entities, _player, bounds,
-                                   _player_settings, _rng);
+    // handle any timed events that are due
+    _timers.advance(delta_time, _due_events);
+    for (auto const event : _due_events) {
+        switch (event) {
+        case timed_event::spawn_munchable:
+            // create a new munchable entity, and wait for the next one
+            _munchable_settings.create(_entities, _player, bounds,
+                                       _player_settings, _rng);
+            _timers.schedule(_munchable_settings.munch_delay(_rng), timed_event::spawn_munchable);
+            break;
+        }
     }
+    _due_events.clear();
     // physics systems
-    systems::accelerate_player(_entities, _player, _input, delta_time);
+    systems::accelerate_player(_entities, _player, input, delta_time);
     systems::move_munchies(_entities, delta_time);
 
     // mechanics systems
     systems::munch(_entities, _player);
 
-    // get the size of the screen to filter out munchables
-    systems::filter_munchables(_entities, window_size.x, window_size.y);
+    // filter out munchables that have left the screen
+    systems::filter_munchables(_entities, static_cast<std::uint32_t>(bounds.w),
+                               static_cast<std::uint32_t>(bounds.h));
+}
+
+void muncher::start_pipeline(bool bounded_latency)
+{
+    if (_simulation.joinable()) {
+        return;
+    }
+    _frames = std::make_unique<ion::frame_pipeline<systems::render_snapshot>>(bounded_latency);
+    _bounded_latency = bounded_latency;
+    _is_frame_in_flight = false;
+    _simulation = std::jthread{ [this](std::stop_token stop) { run_simulation(stop); } };
+}
+
+void muncher::stop_pipeline()
+{
+    if (not _simulation.joinable()) {
+        return;
+    }
+    _frames->stop();
+    _simulation.request_stop();
+    _simulation.join();
+    _inputs.clear();
+}
+
+void muncher::update_pipelined(float delta_time)
+{
+    // with bounded latency, take the frame that was simulated while the last one was being
+    // rendered before handing over the next input, so the simulation stays one frame ahead
+    if (_bounded_latency and _is_frame_in_flight) {
+        _frames->wait_consume();
+    } else {
+        _frames->consume();
+    }
+    {
+        std::scoped_lock lock{ _input_mutex };
+        _inputs.push_back({ delta_time, _input.x(), _input.y(), window_bounds(),
+                            std::exchange(_reset_requested, false) });
+    }
+    _input_ready.notify_one();
+    _is_frame_in_flight = true;
 
-    // render
-    systems::render(GEditor->renderer.get(), _entities);
+    // render the last frame while the simulation works on this one
+    ion::scoped_timer const timer{ _render_times };
+    systems::render(GEditor->renderer.get(), _quads, _frames->front());
+}
+
+void muncher::run_simulation(std::stop_token stop)
+{
+    std::vector<frame_input> pending;
+    while (true) {
+        {
+            std::unique_lock lock{ _input_mutex };
+            if (not _input_ready.wait(lock, stop, [this] { return not _inputs.empty(); })) {
+                return;
+            }
+            pending.swap(_inputs);
+        }
+        // simulate every frame that's been handed over, but only snapshot the last one
+        for (auto const & input : pending) {
+            if (input.reset) {
+                respawn_player(input.bounds);
+            }
+            simulate(input.delta_time, sampled_axis{ input.x, input.y }, input.bounds);
+        }
+        systems::extract_render(_entities, _bounds, pending.back().bounds, _frames->back(),
+                                _steps.alpha());
+        pending.clear();
+        if (not _frames->publish()) {
+            return;
+        }
+    }
 }
 
 void muncher::reset()
+{
+    // the entities belong to the simulation thread while the pipeline runs
+    if (_simulation.joinable()) {
+        _reset_requested = true;
+        return;
+    }
+    respawn_player(window_bounds());
+}
+
+void muncher::step_rate(double hz)
+{
+    _steps.step_rate(hz);
+}
+
+void muncher::respawn_player(SDL_FRect const & bounds)
 {
     // destroy the player if they exist
     if (_entities.valid(_player)) {
         _entities.destroy(_player);
     }
     // then reinstantiate them with default settings
-    SDL_Point window_size;
-    SDL_GetWindowSize(GEditor->window.get(), &window_size.x, &window_size.y);
-    const SDL_FRect bounds{ 0.f, 0.f, static_cast<float>(window_size.x),
-                                      static_cast<float>(window_size.y) };
     _player = _player_settings.create(_entities, bounds);
 }
 
@@ -81,6 +81,10 @@ void munch(entt::registry & entities, entt::entity player)
     // otherwise munch all colliding munchables
     else {
         ranges::for_each(colliding_munchables, grow_player);
+        if (not colliding_munchables.empty()) {
+            // let whatever tracks the boxes know the player grew
+            entities.patch<cmpt::bbox>(player);
+        }
         entities.destroy(colliding_munchables.begin(),
                          colliding_munchables.end());
     }
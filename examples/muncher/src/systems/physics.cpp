@@ -36,13 +36,24 @@ void accelerate_player(entt::registry & entities, entt::entity player,
     v = speed * normalized(v, eps);
 }
 
+void store_previous_bounds(entt::registry & entities)
+{
+    for (auto const [entity, box] : entities.view<cmpt::bbox const>().each()) {
+        entities.emplace_or_replace<cmpt::previous_bbox>(entity, box.x, box.y, box.size);
+    }
+}
+
 void move_munchies(entt::registry & entities, float dt)
 {
+    // move them through the registry, so that whatever tracks the boxes sees them move
     auto munchies = entities.view<cmpt::bbox, cmpt::velocity const>();
-    munchies.each([dt](auto & p, auto const & v) {
-        p.x += v.x * dt;
-        p.y -= v.y * dt;
-    });
+    for (auto const munchy : munchies) {
+        auto const & v = munchies.get<cmpt::velocity const>(munchy);
+        entities.patch<cmpt::bbox>(munchy, [&v, dt](auto & p) {
+            p.x += v.x * dt;
+            p.y -= v.y * dt;
+        });
+    }
 }
 
 bool collides_with(cmpt::bbox const & a, cmpt::bbox const & b)
@@ -2,6 +2,8 @@
 #include "Pipes/Tile/Tile.hpp"
 #include "Pipes/Deck.hpp"
 
+#include <ion/engine/tint_blit.hpp>
+
 #include <SDL3/SDL_rect.h>
 #include <SDL3/SDL_video.h>
 #include <SDL3/SDL_render.h>
@@ -9,12 +11,39 @@
 #include <array>
 #include <algorithm>
 
+namespace
+{
+bool same_color(const SDL_Color & lhs, const SDL_Color & rhs)
+{
+    return lhs.r == rhs.r and lhs.g == rhs.g and lhs.b == rhs.b and lhs.a == rhs.a;
+}
+
+// the cell a tile was in when its damage was last marked, so moving it can damage both cells
+struct marked_cell
+{
+    SDL_Point cell;
+};
+}
+
 Pipes::Board::Board(TileMap && loaded_tiles,
                     const TileSettings & tile_settings)
 
     : tile_settings(tile_settings),
       loaded_tiles(std::move(loaded_tiles))
 {
+    entities.on_construct<Component::Position>().connect<&Board::on_tile_moved>(this);
+    entities.on_update<Component::Position>().connect<&Board::on_tile_moved>(this);
+    entities.on_update<Component::Tile>().connect<&Board::on_tile_changed>(this);
+    entities.on_destroy<Component::Position>().connect<&Board::on_tile_destroyed>(this);
+}
+
+Pipes::Board::~Board()
+{
+    // the placed tiles outlive the damaged cells, so stop listening before they are destroyed
+    entities.on_construct<Component::Position>().disconnect(this);
+    entities.on_update<Component::Position>().disconnect(this);
+    entities.on_update<Component::Tile>().disconnect(this);
+    entities.on_destroy<Component::Position>().disconnect(this);
 }
 
 bool Pipes::Board::has_tile(int x, int y) const
@@ -40,19 +69,26 @@ Pipes::TileHandle Pipes::Board::draw_from(Pipes::Deck & deck, const SDL_Point &
     tile.position(position);
 
     const auto [name, rotation] = deck.next_tile();
-    tile.name() = name;
-    tile.rotation() = rotation;
-    tile.color() = has_adjacent_tile(position)? tile_settings.placeable_color
-                                              : tile_settings.distant_color;
+    tile.name(name);
+    tile.rotation(rotation);
+    tile.color(has_adjacent_tile(position)? tile_settings.placeable_color
+                                          : tile_settings.distant_color);
 
     return tile;
 }
 
 void Pipes::Board::place_tile(Pipes::TileHandle && tile)
 {
-    tile.color() = tile_settings.static_color;
+    tile.color(tile_settings.static_color);
     const SDL_Point position = tile.position();
-    placed_tiles.try_emplace(position, std::move(tile));
+    const TileInfo::Name name = tile.name();
+    const TileInfo::Rotation rotation = tile.rotation();
+    const entt::entity entity = tile.entity();
+    if (not placed_tiles.try_emplace(position, std::move(tile)).second) { return; }
+
+    entities.emplace_or_replace<Component::Placed>(entity);
+    placed_index.insert(entity, ion::spatial_bounds<int>{ position.x, position.y, 1, 1 });
+    placed_layer.place(position.x, -position.y, TileMap::atlas_id(name, rotation), tile_settings.static_color);
 }
 
 SDL_Point Pipes::Board::nearest_point(int x, int y) const
@@ -75,29 +111,200 @@ SDL_Rect Pipes::Board::unit_square(int x, int y) const
                      unit_size, unit_size };
 }
 
-void Pipes::Board::render(SDL_Window * window) const
+void Pipes::Board::render(SDL_Window * window)
 {
-    // clear the screen
     auto screen = SDL_GetWindowSurface(window);
+    if (not screen) { return; }
+
+    // a new window size or unit size means every tile image has to be prepared again
+    const int unit_size = static_cast<int>(transform.scale.x);
+    blits.format(screen->format);
+    damage.bounds(SDL_Rect{ 0, 0, screen->w, screen->h });
+    if (screen->w != drawn_surface_size.x or screen->h != drawn_surface_size.y or unit_size != drawn_unit_size)
+    {
+        blits.clear();
+        drawn_surface_size = { screen->w, screen->h };
+        drawn_unit_size = unit_size;
+        damage.mark_all();
+    }
+
+    // so does moving the board, changing the background, or an image finishing loading
+    const glm::mat3x3 basis = transform.global_basis();
+    const std::size_t num_images = loaded_tiles.num_loaded();
+    if (basis != drawn_basis or not same_color(drawn_background, background_color) or num_images != drawn_images)
+    {
+        damage.mark_all();
+        drawn_basis = basis;
+        drawn_background = background_color;
+        drawn_images = num_images;
+    }
+    mark_damaged_cells();
+    if (damage.empty()) { return; }
+
+    if (not raster_dirty_rects(screen)) { blit_dirty_rects(screen); }
+
+    const auto dirty_rects = damage.rects();
+    SDL_UpdateWindowSurfaceRects(window, dirty_rects.data(), static_cast<int>(dirty_rects.size()));
+    damage.clear();
+}
+
+bool Pipes::Board::raster_dirty_rects(SDL_Surface * screen)
+{
+    if (not raster.begin(screen)) { return false; }
+
+    // record each dirty rect clipped, so that tiles straddling it don't draw outside of it
+    const ion::camera2f camera{ transform, static_cast<float>(screen->w), static_cast<float>(screen->h) };
+    for (const SDL_Rect & dirty : damage.rects())
+    {
+        raster.clip(&dirty);
+        raster.fill(dirty, background_color);
+
+        for (const entt::entity entity : tiles_under(camera, dirty))
+        {
+            const auto & [tile, position] = entities.get<Component::Tile, Component::Position>(entity);
+            SDL_Rect grid_square = unit_square(position);
+            SDL_Surface * tile_surface = blits.prepared(loaded_tiles.image_for(tile.name, tile.rotation),
+                                                        grid_square.w, grid_square.h);
+
+            // tile images load in the background, so only the color is drawn until they're ready
+            if (not tile_surface) { raster.fill(grid_square, tile.color); }
+            else if (not raster.tint_blit(tile_surface, grid_square, tile.color))
+            {
+                raster.discard();
+                return false;
+            }
+        }
+    }
+    raster.end();
+    return true;
+}
+
+void Pipes::Board::blit_dirty_rects(SDL_Surface * screen)
+{
+    const std::uint32_t bg_color = blits.map(background_color);
+
+    // redraw each dirty rect, clipped so that tiles straddling it don't draw outside of it
+    const ion::camera2f camera{ transform, static_cast<float>(screen->w), static_cast<float>(screen->h) };
+    for (const SDL_Rect & dirty : damage.rects())
+    {
+        SDL_SetSurfaceClipRect(screen, &dirty);
+        SDL_FillSurfaceRect(screen, &dirty, bg_color);
 
-    const auto * pixel_format = SDL_GetPixelFormatDetails(screen->format);
-    const int bg_color = SDL_MapRGB(pixel_format, nullptr,
-                                    background_color.r, background_color.g, background_color.b);
+        for (const entt::entity entity : tiles_under(camera, dirty))
+        {
+            // get the sdl surface to render from and the grid square to render to
+            const auto & [tile, position] = entities.get<Component::Tile, Component::Position>(entity);
+            SDL_Rect grid_square = unit_square(position);
+            SDL_Surface * tile_surface = blits.prepared(loaded_tiles.image_for(tile.name, tile.rotation),
+                                                        grid_square.w, grid_square.h);
 
-    SDL_FillSurfaceRect(screen, nullptr, bg_color);
+            // color the background and draw the tile in one pass when the formats allow it
+            if (tile_surface and ion::tint_blit(tile_surface, screen, grid_square, tile.color)) { continue; }
+            SDL_FillSurfaceRect(screen, &grid_square, blits.map(tile.color));
 
-    // draw the tiles and update the window
-    entities.view<Component::Tile, Component::Position>()
+            // tile images load in the background, so only the color is drawn until they're ready
+            if (tile_surface)
+            {
+                SDL_BlitSurface(tile_surface, nullptr, screen, &grid_square);
+            }
+        }
+    }
+    SDL_SetSurfaceClipRect(screen, nullptr);
+}
+
+const std::vector<entt::entity> &
+Pipes::Board::tiles_under(const ion::camera2f & camera, const SDL_Rect & region)
+{
+    found_tiles.clear();
+    const ion::camera2f::bounds_t screen_region{ static_cast<float>(region.x), static_cast<float>(region.y),
+                                                 static_cast<float>(region.w), static_cast<float>(region.h) };
+    placed_index.query(camera.covered_cells(screen_region), [this](const entt::entity entity)
+    {
+        found_tiles.push_back(entity);
+    });
+
+    // tiles that haven't been placed are few and move around, so they're checked one by one
+    entities.view<Component::Position>(entt::exclude<Component::Placed>)
+            .each([&](const entt::entity entity, const auto & position)
+    {
+        const SDL_Rect grid_square = unit_square(position);
+        if (SDL_HasRectIntersection(&grid_square, &region)) { found_tiles.push_back(entity); }
+    });
+    return found_tiles;
+}
+
+void Pipes::Board::on_tile_moved(entt::registry & registry, entt::entity entity)
+{
+    const auto cell = static_cast<SDL_Point>(registry.get<Component::Position>(entity));
+    if (auto * marked = registry.try_get<marked_cell>(entity))
+    {
+        damaged_cells.push_back(marked->cell);
+        marked->cell = cell;
+    }
+    else
+    {
+        registry.emplace<marked_cell>(entity, cell);
+    }
+    damaged_cells.push_back(cell);
+}
+
+void Pipes::Board::on_tile_changed(entt::registry & registry, entt::entity entity)
+{
+    if (const auto * position = registry.try_get<Component::Position>(entity))
+    {
+        damaged_cells.push_back(static_cast<SDL_Point>(*position));
+    }
+}
+
+void Pipes::Board::on_tile_destroyed(entt::registry & registry, entt::entity entity)
+{
+    // whatever was under the tile is exposed
+    damaged_cells.push_back(static_cast<SDL_Point>(registry.get<Component::Position>(entity)));
+}
+
+void Pipes::Board::mark_damaged_cells()
+{
+    for (const SDL_Point & cell : damaged_cells)
+    {
+        damage.mark(unit_square(cell));
+    }
+    damaged_cells.clear();
+}
+
+void Pipes::Board::render(SDL_Renderer * renderer)
+{
+    // clear the screen
+    SDL_SetRenderDrawColor(renderer, background_color.r, background_color.g, background_color.b, 0xff);
+    SDL_RenderClear(renderer);
+
+    // tiles are drawn with just their color until the atlas is ready
+    const ion::texture_atlas * atlas = loaded_tiles.atlas(renderer);
+    placed_layer.atlas(atlas);
+    placed_layer.tile_size(static_cast<int>(transform.scale.x));
+    const SDL_Rect origin_square = unit_square(0, 0);
+    placed_layer.render(renderer, SDL_FPoint{ static_cast<float>(origin_square.x),
+                                              static_cast<float>(origin_square.y) });
+
+    int width = 0, height = 0;
+    SDL_GetCurrentRenderOutputSize(renderer, &width, &height);
+    const ion::camera2f camera{ transform, static_cast<float>(width), static_cast<float>(height) };
+
+    tile_renderer.atlas(atlas);
+    tile_renderer.clear();
+    entities.view<Component::Tile, Component::Position>(entt::exclude<Component::Placed>)
             .each([&](const auto & tile, const auto & position)
     {
-        // get the sdl surface to render from and the grid square to render to
-        SDL_Surface * tile_surface = loaded_tiles.image_for(tile.name, tile.rotation);
-        SDL_Rect grid_square = unit_square(position);
-
-        // color the background and draw the til
-        const int fg_color = SDL_MapRGB(pixel_format, nullptr, tile.color.r, tile.color.g, tile.color.b);
-        SDL_FillSurfaceRect(screen, &grid_square, fg_color);
-        SDL_BlitSurfaceScaled(tile_surface, nullptr, screen, &grid_square, SDL_SCALEMODE_NEAREST);
+        if (not camera.is_visible({ static_cast<float>(position.x), static_cast<float>(position.y), 1.f, 1.f }))
+        {
+            return;
+        }
+        const SDL_Rect grid_square = unit_square(position);
+        SDL_FRect dst;
+        SDL_RectToFRect(&grid_square, &dst);
+
+        tile_renderer.fill(color_layer, dst, tile.color);
+        tile_renderer.draw(image_layer, TileMap::atlas_id(tile.name, tile.rotation), dst);
     });
-    SDL_UpdateWindowSurface(window);
+    tile_renderer.render(renderer);
+    SDL_RenderPresent(renderer);
 }
\ No newline at end of file
@@ -29,7 +29,7 @@ void Pipes::Hand::on_cursor_moved(int x, int y)
         else
         {
             current_tile->position(mouse);
-            current_tile->color() = color;
+            current_tile->color(color);
         }
     }
 }
@@ -38,8 +38,9 @@ void Pipes::Hand::on_cursor_scrolled(int dy)
 {
     if (current_tile)
     {
-        if (dy > 0) { ++current_tile->rotation(); }
-        else if (dy < 0) { --current_tile->rotation(); }
+        TileInfo::Rotation rotation = current_tile->rotation();
+        if (dy > 0) { current_tile->rotation(++rotation); }
+        else if (dy < 0) { current_tile->rotation(--rotation); }
     }
 }
 
@@ -48,8 +49,8 @@ Pipes::TileHandle Pipes::Hand::pop_cache()
     auto tile = TileHandle(board->entities);
     if (cached_tile)
     {
-        tile.name() = cached_tile->name;
-        tile.rotation() = cached_tile->rotation;
+        tile.name(cached_tile->name);
+        tile.rotation(cached_tile->rotation);
         cached_tile = std::nullopt;
     }
     return tile;
@@ -4,6 +4,7 @@
 #include <ion/engine.hpp>
 #include <ion/editor.hpp>
 #include <ion/input/axis.hpp>
+#include <ion/time.hpp>
 #include <iostream>
 
 #include <ion/serialization/paths.hpp>
@@ -15,6 +16,8 @@ ion::editor * GEditor = nullptr;
 
 int main(int argc, char * argv[])
 {
+    if (not ion::session::from_args(argc, argv)) { return EXIT_FAILURE; }
+
     const fs::path root_dir = ion::paths::root_dir();
     ion::editor_settings::config_path((root_dir/"resources/settings.yaml").string());
     SDL_Log("Config Dir: %s\n", ion::editor_settings::config_path().data());
@@ -30,11 +33,15 @@ int main(int argc, char * argv[])
     constexpr Pipes::TileSettings tile_settings;
     Pipes::App game{ game_settings, tile_settings };
 
-    // otherwise run the game
+    // otherwise run the game, paced by vsync when there's a renderer to present with
     game.start();
+    auto loop = game_settings.hardware_rendering? ion::run_loop::vsync(editor->renderer.get())
+                                                : ion::run_loop::capped(60.0);
+    ion::clock clock;
     while (not editor->has_quit())
     {
-        ion::sdl_events::poll();
+        loop.wait();
+        ion::session::poll(clock.tick());
         game.update();
     }
     return EXIT_SUCCESS;
@@ -43,9 +50,12 @@ int main(int argc, char * argv[])
 Pipes::App::App(const GameSettings & game_settings,
                 const TileSettings & tile_settings)
 
-    : _rng(std::random_device{}()),
+    : _rng(ion::session::seed()),
+      assets(loader),
+
+      hardware_rendering(game_settings.hardware_rendering),
 
-      board(TileMap(game_settings.tiles_directory), tile_settings),
+      board(TileMap(game_settings.tiles_directory, assets), tile_settings),
 
       deck(_rng, game_settings.deck_size),
       hand(board)
@@ -71,6 +81,9 @@ void Pipes::App::start()
     const SDL_Point mouse = board.nearest_point(ion::input::mouse_position());
     hand.current_tile = board.draw_from(deck, mouse);
 
+    // the hand only cares where the mouse ends up each frame, but every scroll should rotate
+    ion::sdl_events::coalesce(SDL_EVENT_MOUSE_MOTION, true);
+
     // bind the mouse to the tile hand
     ion::sdl_events::on_mouse_scroll().connect<&Hand::on_cursor_scrolled>(hand);
     ion::sdl_events::on_mouse_moved().connect<&Hand::on_cursor_moved>(hand);
@@ -81,7 +94,8 @@ void Pipes::App::start()
 
 void Pipes::App::update()
 {
-    board.render(GEditor->window.get());
+    if (hardware_rendering) { board.render(GEditor->renderer.get()); }
+    else { board.render(GEditor->window.get()); }
 }
 
 void Pipes::App::on_mouse_clicked()
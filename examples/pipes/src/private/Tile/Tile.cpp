@@ -54,14 +54,19 @@ Pipes::TileHandle & Pipes::TileHandle::operator=(Pipes::TileHandle && other) noe
     return *this;
 }
 
+entt::entity Pipes::TileHandle::entity() const
+{
+    return id;
+}
+
 Pipes::TileInfo::Name Pipes::TileHandle::name() const
 {
     return entities->get<Component::Tile>(id).name;
 }
 
-Pipes::TileInfo::Name & Pipes::TileHandle::name()
+void Pipes::TileHandle::name(TileInfo::Name name)
 {
-    return entities->get<Component::Tile>(id).name;
+    entities->patch<Component::Tile>(id, [name](auto & tile) { tile.name = name; });
 }
 
 SDL_Point Pipes::TileHandle::position() const
@@ -71,9 +76,11 @@ SDL_Point Pipes::TileHandle::position() const
 
 void Pipes::TileHandle::position(int x, int y)
 {
-    auto & position = entities->get<Component::Position>(id);
-    position.x = x;
-    position.y = y;
+    entities->patch<Component::Position>(id, [x, y](auto & position)
+    {
+        position.x = x;
+        position.y = y;
+    });
 }
 
 Pipes::TileInfo::Rotation Pipes::TileHandle::rotation() const
@@ -81,9 +88,9 @@ Pipes::TileInfo::Rotation Pipes::TileHandle::rotation() const
     return entities->get<Component::Tile>(id).rotation;
 }
 
-Pipes::TileInfo::Rotation& Pipes::TileHandle::rotation()
+void Pipes::TileHandle::rotation(TileInfo::Rotation rotation)
 {
-    return entities->get<Component::Tile>(id).rotation;
+    entities->patch<Component::Tile>(id, [rotation](auto & tile) { tile.rotation = rotation; });
 }
 
 const SDL_Color& Pipes::TileHandle::color() const
@@ -91,7 +98,7 @@ const SDL_Color& Pipes::TileHandle::color() const
     return entities->get<Component::Tile>(id).color;
 }
 
-SDL_Color& Pipes::TileHandle::color()
+void Pipes::TileHandle::color(const SDL_Color & color)
 {
-    return entities->get<Component::Tile>(id).color;
+    entities->patch<Component::Tile>(id, [&color](auto & tile) { tile.color = color; });
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Pipes/Tile/TileMap.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <filesystem>
 #include <string_view>
@@ -11,7 +12,7 @@
 
 namespace fs = std::filesystem;
 
-Pipes::TileMap::TileMap(const std::string_view images_path)
+Pipes::TileMap::TileMap(const std::string_view images_path, ion::resource_cache & cache)
 {
     std::stringstream filename;
 
@@ -29,12 +30,9 @@ Pipes::TileMap::TileMap(const std::string_view images_path)
         for (const auto rotation : TileInfo::rotations)
         {
             filename << name << "-" << rotation << ".bmp";
+            // the loader logs any tile image that's missing or can't be decoded
             const auto filepath = images_dir/filename.str();
-            if (not std::filesystem::exists(filepath))
-            {
-                SDL_Log("Expecting tile image at path %s but it doesn't exist!\n", filepath.string().c_str());
-            }
-            tiles.try_emplace(TileID{ name, rotation }, ion::load_bitmap(filepath.string()));
+            tiles.try_emplace(TileID{ name, rotation }, cache.load_surface(filepath.string()));
             filename.str("");
         }
     }
@@ -48,3 +46,34 @@ SDL_Surface * Pipes::TileMap::image_for(TileInfo::Name name, TileInfo::Rotation
     }
     return nullptr;
 }
+
+std::size_t Pipes::TileMap::num_loaded() const
+{
+    return static_cast<std::size_t>(std::ranges::count_if(tiles, [](const auto & tile) { return tile.second.is_done(); }));
+}
+
+const ion::texture_atlas * Pipes::TileMap::atlas(SDL_Renderer * renderer) const
+{
+    if (has_built_atlas) { return tile_atlas? &tile_atlas : nullptr; }
+    if (not std::ranges::all_of(tiles, [](const auto & tile) { return tile.second.is_done(); }))
+    {
+        return nullptr;
+    }
+
+    // pack the images once they've all loaded - any that failed are left out of the atlas
+    ion::atlas_builder builder;
+    for (const auto & [id, image] : tiles)
+    {
+        builder.add(atlas_id(id.name, id.rotation), image.get());
+    }
+    tile_atlas = builder.build(renderer);
+    has_built_atlas = true;
+    return tile_atlas? &tile_atlas : nullptr;
+}
+
+std::uint32_t Pipes::TileMap::atlas_id(TileInfo::Name name, TileInfo::Rotation rotation)
+{
+    // every name has a run of ids, one for each rotation, so no two tiles share an id
+    return static_cast<std::uint32_t>(name)*static_cast<std::uint32_t>(TileInfo::rotations.size())
+         + static_cast<std::uint32_t>(rotation);
+}
@@ -2,10 +2,19 @@
 #include "Pipes/Grid.hpp"
 #include "Pipes/PointSet.hpp"
 #include "Pipes/Tile.hpp"
+#include "ion/camera.hpp"
 #include "ion/transform.hpp"
+#include <ion/engine/blit_cache.hpp>
+#include <ion/engine/chunked_tile_layer.hpp>
+#include <ion/engine/dirty_region.hpp>
+#include <ion/engine/soft_raster.hpp>
+#include <ion/engine/tilemap_renderer.hpp>
+#include <ion/containers/spatial_grid.hpp>
 #include <entt/entity/registry.hpp>
 
+struct SDL_Surface;
 struct SDL_Window;
+struct SDL_Renderer;
 
 namespace Pipes
 {
@@ -16,6 +25,11 @@ class Board
 public:
     Board(TileMap && loaded_tiles,
           const TileSettings & tile_settings = TileSettings{});
+    ~Board();
+
+    // the board listens to its own registry, so it has to stay where it was made
+    Board(const Board &) = delete;
+    Board & operator=(const Board &) = delete;
 
     bool has_tile(int x, int y) const;
     bool has_tile(const Point auto & p) const;
@@ -31,7 +45,12 @@ public:
 
     SDL_Rect unit_square(int x, int y) const;
     SDL_Rect unit_square(const Point auto & p) const;
-    void render(SDL_Window * window) const;
+
+    /** Draw the board in software to a window's surface, redrawing only what changed */
+    void render(SDL_Window * window);
+
+    /** Draw the board with a renderer, batching the tiles by layer */
+    void render(SDL_Renderer * renderer);
 
     const TileSettings tile_settings;
 
@@ -41,8 +60,47 @@ public:
 
     SDL_Color background_color{ 0x0, 0x0, 0x0, 0xff };
 private:
+    void on_tile_moved(entt::registry & registry, entt::entity entity);
+    void on_tile_changed(entt::registry & registry, entt::entity entity);
+    void on_tile_destroyed(entt::registry & registry, entt::entity entity);
+    void mark_damaged_cells();
+    bool raster_dirty_rects(SDL_Surface * screen);
+    void blit_dirty_rects(SDL_Surface * screen);
+    const std::vector<entt::entity> & tiles_under(const ion::camera2f & camera, const SDL_Rect & region);
+
     const TileMap loaded_tiles;
     PointSet placed_tiles;
+
+    // placed tiles indexed by chunks of the board, so finding the tiles in a region of the
+    // screen doesn't depend on how big the board is
+    ion::spatial_grid<entt::entity, int> placed_index{ 16 };
+    std::vector<entt::entity> found_tiles;
+
+    // the registry's listeners record the cells of tiles that were made, changed, moved or
+    // destroyed, and the software renderer marks them as damage when it next draws
+    ion::dirty_region damage;
+    std::vector<SDL_Point> damaged_cells;
+    SDL_Color drawn_background{ 0x0, 0x0, 0x0, 0x0 };
+    glm::mat3x3 drawn_basis{ 0.f };
+    std::size_t drawn_images = 0;
+
+    // tile images prepared for the window's format at the current unit size
+    ion::blit_cache blits;
+    SDL_Point drawn_surface_size{ 0, 0 };
+    int drawn_unit_size = 0;
+
+    // dirty rects are redrawn on several threads when every tile can be tint blitted
+    ion::soft_raster raster;
+
+    // placed tiles never change, so they're baked into chunks - the board's y axis points up,
+    // so tile x, y is cell x, -y of the layer
+    ion::chunked_tile_layer placed_layer;
+
+    // tiles that haven't been placed are drawn one by one over the placed ones, with their
+    // colors in the first layer and their images over them in the second
+    static constexpr std::size_t color_layer = 0;
+    static constexpr std::size_t image_layer = 1;
+    ion::tilemap_renderer tile_renderer{ 2 };
 };
 }
 
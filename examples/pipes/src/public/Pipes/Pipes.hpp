@@ -6,6 +6,7 @@
 #include "Pipes/Tile/TileSettings.hpp"
 
 #include <entt/entt.hpp>
+#include <ion/engine/resource_cache.hpp>
 
 #include <random>
 
@@ -17,6 +18,7 @@ struct GameSettings
     std::uint32_t unit_size = 100;
     SDL_Color background_color{ 0x0, 0x0, 0x0, 0xff };
     std::string tiles_directory = "tiles";
+    bool hardware_rendering = true;
 };
 }
 
@@ -32,7 +34,8 @@ inline auto reflect<Pipes::GameSettings>()
         .data<&Pipes::GameSettings::deck_size>("deck-size"_hs)
         .data<&Pipes::GameSettings::unit_size>("unit-size"_hs)
         .data<&Pipes::GameSettings::background_color>("background-color"_hs)
-        .data<&Pipes::GameSettings::tiles_directory>("tiles-directory"_hs);
+        .data<&Pipes::GameSettings::tiles_directory>("tiles-directory"_hs)
+        .data<&Pipes::GameSettings::hardware_rendering>("hardware-rendering"_hs);
 }
 }
 
@@ -54,7 +57,12 @@ private:
     // ecs
     engine_t _rng;
 
+    // assets
+    ion::asset_loader loader;
+    ion::resource_cache assets;
+
     // tile
+    bool hardware_rendering;
     Board board;
     Deck deck;
     Hand hand;
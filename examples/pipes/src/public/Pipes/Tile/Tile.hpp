@@ -18,6 +18,9 @@ struct Position {
     int x, y;
     inline explicit operator SDL_Point() const { return {x, y}; }
 };
+
+// tags tiles that have been placed on the board, and so won't change anymore
+struct Placed {};
 }
 
 namespace Pipes
@@ -35,18 +38,22 @@ public:
     TileHandle(TileHandle && other) noexcept;
     TileHandle& operator=(TileHandle && other) noexcept;
 
+    entt::entity entity() const;
+
+    // the setters patch the tile's components, so that registry listeners see every change
+
     TileInfo::Name name() const;
-    TileInfo::Name& name();
+    void name(TileInfo::Name name);
 
     SDL_Point position() const;
     void position(int x, int y);
     void position(const Point auto & p);
 
     TileInfo::Rotation rotation() const;
-    TileInfo::Rotation& rotation();
+    void rotation(TileInfo::Rotation rotation);
 
     const SDL_Color& color() const;
-    SDL_Color& color();
+    void color(const SDL_Color & color);
 protected:
     entt::entity id;
     entt::registry * entities;
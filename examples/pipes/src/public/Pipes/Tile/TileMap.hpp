@@ -1,7 +1,10 @@
 #pragma once
 #include "Pipes/Tile/TileInfo.hpp"
+#include <cstdint>
 #include <string_view>
-#include <ion/engine/sdl_resources.hpp>
+#include <unordered_map>
+#include <ion/engine/resource_cache.hpp>
+#include <ion/engine/texture_atlas.hpp>
 
 namespace ion
 {
@@ -9,6 +12,7 @@ class surface;
 }
 
 struct SDL_Surface;
+struct SDL_Renderer;
 
 namespace Pipes
 {
@@ -38,10 +42,29 @@ namespace Pipes
 class TileMap
 {
 public:
-    TileMap(std::string_view images_path);
+    /** Start loading the tile images in the background */
+    TileMap(std::string_view images_path, ion::resource_cache & cache);
+
+    /** The image for a tile, or nullptr if it hasn't finished loading */
     SDL_Surface * image_for(TileInfo::Name name, TileInfo::Rotation rotation) const;
+
+    /** The number of tile images that have finished loading, or failed to */
+    std::size_t num_loaded() const;
+
+    /**
+     * An atlas of every tile image, which is packed the first time it's asked for once all of
+     * the images have finished loading
+     * \return the atlas, or nullptr if the images are still loading or couldn't be packed
+     */
+    const ion::texture_atlas * atlas(SDL_Renderer * renderer) const;
+
+    /** The id a tile's image has in the atlas */
+    static std::uint32_t atlas_id(TileInfo::Name name, TileInfo::Rotation rotation);
+
 private:
     TileMap() = default;
-    std::unordered_map<TileID, ion::sdl_surface> tiles;
+    std::unordered_map<TileID, ion::surface_handle> tiles;
+    mutable ion::texture_atlas tile_atlas;
+    mutable bool has_built_atlas = false;
 };
 }
@@ -0,0 +1,134 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+
+#include <glm/glm.hpp>
+#include <ion/containers/spatial_grid.hpp>
+
+#include "ion/transform.hpp"
+
+namespace ion
+{
+/**
+ * A view of the world through a transform from world coordinates to screen coordinates
+ *
+ * The camera answers which part of the world is on screen, so that rendering can skip
+ * anything outside of it. Bounds are axis-aligned in both spaces, so with a rotated view the
+ * world bounds cover a bit more than what's actually visible.
+ */
+template<std::floating_point Float>
+class camera2
+{
+public:
+    using transform_t = transform2<Float>;
+    using vector_t = typename transform_t::vector_t;
+    using bounds_t = spatial_bounds<Float>;
+
+    /**
+     * \param world_to_screen the transform from world to screen coordinates
+     * \param width the width of the screen
+     * \param height the height of the screen
+     */
+    camera2(const transform_t & world_to_screen, Float width, Float height);
+
+    vector_t to_screen(const vector_t & world) const;
+    vector_t to_world(const vector_t & screen) const;
+
+    /** The bounds in screen coordinates of a region of the world */
+    bounds_t to_screen(const bounds_t & world) const;
+
+    /** The bounds in world coordinates of a region of the screen */
+    bounds_t to_world(const bounds_t & screen) const;
+
+    /** The bounds of the world that are on screen */
+    bounds_t view_bounds() const { return to_world(bounds_t{ 0, 0, width, height }); }
+
+    /** Determine if any of a region of the world is on screen */
+    bool is_visible(const bounds_t & world) const { return view_bounds().intersects(world); }
+
+    /**
+     * The unit cells of a grid in world coordinates that a region of the screen covers
+     * \param screen the region of the screen
+     * \return the covered cells, with cell x, y spanning x to x + 1 and y to y + 1 in the world
+     */
+    spatial_bounds<int> covered_cells(const bounds_t & screen) const;
+private:
+    static bounds_t transformed(const typename transform_t::matrix_t & basis, const bounds_t & bounds);
+
+    typename transform_t::matrix_t world_to_screen;
+    typename transform_t::matrix_t screen_to_world;
+    Float width;
+    Float height;
+};
+
+using camera2f = camera2<float>;
+using camera2d = camera2<double>;
+}
+
+template<std::floating_point Float>
+ion::camera2<Float>::camera2(const transform_t & world_to_screen, Float width, Float height)
+    : world_to_screen{ world_to_screen.global_basis() },
+      screen_to_world{ glm::inverse(this->world_to_screen) },
+      width{ width }, height{ height }
+{
+}
+
+template<std::floating_point Float>
+ion::camera2<Float>::vector_t ion::camera2<Float>::to_screen(const vector_t & world) const
+{
+    return vector_t{ world_to_screen * glm::vec<3, Float, glm::defaultp>{ world, 1 } };
+}
+
+template<std::floating_point Float>
+ion::camera2<Float>::vector_t ion::camera2<Float>::to_world(const vector_t & screen) const
+{
+    return vector_t{ screen_to_world * glm::vec<3, Float, glm::defaultp>{ screen, 1 } };
+}
+
+template<std::floating_point Float>
+ion::camera2<Float>::bounds_t ion::camera2<Float>::to_screen(const bounds_t & world) const
+{
+    return transformed(world_to_screen, world);
+}
+
+template<std::floating_point Float>
+ion::camera2<Float>::bounds_t ion::camera2<Float>::to_world(const bounds_t & screen) const
+{
+    return transformed(screen_to_world, screen);
+}
+
+template<std::floating_point Float>
+ion::spatial_bounds<int> ion::camera2<Float>::covered_cells(const bounds_t & screen) const
+{
+    const bounds_t world = to_world(screen);
+    const int first_x = static_cast<int>(std::floor(world.x));
+    const int first_y = static_cast<int>(std::floor(world.y));
+    const int last_x = static_cast<int>(std::ceil(world.x + world.w));
+    const int last_y = static_cast<int>(std::ceil(world.y + world.h));
+    return spatial_bounds<int>{ first_x, first_y, last_x - first_x, last_y - first_y };
+}
+
+template<std::floating_point Float>
+ion::camera2<Float>::bounds_t
+ion::camera2<Float>::transformed(const typename transform_t::matrix_t & basis, const bounds_t & bounds)
+{
+    // flips and rotations can move any corner to any side, so take the extent of all four
+    using point_t = glm::vec<3, Float, glm::defaultp>;
+    const point_t corners[]{
+        basis * point_t{ bounds.x, bounds.y, 1 },
+        basis * point_t{ bounds.x + bounds.w, bounds.y, 1 },
+        basis * point_t{ bounds.x, bounds.y + bounds.h, 1 },
+        basis * point_t{ bounds.x + bounds.w, bounds.y + bounds.h, 1 }
+    };
+    Float min_x = corners[0].x, max_x = corners[0].x;
+    Float min_y = corners[0].y, max_y = corners[0].y;
+    for (const auto & corner : corners)
+    {
+        min_x = std::min(min_x, corner.x);
+        max_x = std::max(max_x, corner.x);
+        min_y = std::min(min_y, corner.y);
+        max_y = std::max(max_y, corner.y);
+    }
+    return bounds_t{ min_x, min_y, max_x - min_x, max_y - min_y };
+}
\ No newline at end of file
@@ -1,3 +1,5 @@
 #pragma once
 
-#include "ion/containers/lookup_table.hpp"
\ No newline at end of file
+#include "ion/containers/lookup_table.hpp"
+#include "ion/containers/spsc_queue.hpp"
+#include "ion/containers/spatial_grid.hpp"
\ No newline at end of file
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ion
+{
+
+/** An axis-aligned box that covers [x, x + w) by [y, y + h) */
+template<typename Scalar>
+struct spatial_bounds {
+    Scalar x, y, w, h;
+
+    constexpr bool intersects(const spatial_bounds & other) const noexcept
+    {
+        return x < other.x + other.w and other.x < x + w and
+               y < other.y + other.h and other.y < y + h;
+    }
+    constexpr bool operator==(const spatial_bounds &) const = default;
+};
+
+/**
+ * A uniform grid of square cells that indexes keys by their bounds, so that finding what
+ * overlaps a region only looks at the cells the region covers.
+ *
+ * Each key is listed in every cell its bounds touch, and a query visits each key it finds
+ * once, no matter how many of the query's cells the key spans. Cells are only stored while
+ * there's something in them, so the grid can be unbounded and sparse. With an integral
+ * scalar, the cells work as chunks of a tile grid.
+ */
+template<typename Key, typename Scalar = float>
+requires std::is_arithmetic_v<Scalar>
+class spatial_grid {
+public:
+    using key_type = Key;
+    using bounds_type = spatial_bounds<Scalar>;
+    using size_type = std::size_t;
+
+    /** \param cell_size the width and height of a cell */
+    explicit spatial_grid(Scalar cell_size) noexcept
+        : cell_size{ cell_size > Scalar{ 0 }? cell_size : Scalar{ 1 } }
+    {
+    }
+
+    /**
+     * Add a key, or move it if it's already in the grid
+     * \param key the key to index
+     * \param bounds the region the key covers
+     */
+    void insert(const Key & key, const bounds_type & bounds)
+    {
+        const auto [entry, is_new] = entries.try_emplace(key, bounds);
+        if (not is_new)
+        {
+            // keys that stay in the same cells, like most things from one frame to the next,
+            // only need their bounds updated
+            const cell_range old_cells = cells_for(entry->second);
+            const cell_range new_cells = cells_for(bounds);
+            entry->second = bounds;
+            if (old_cells == new_cells)
+            {
+                for_each_cell(new_cells, [&](std::uint64_t cell)
+                {
+                    for (auto & item : cells[cell]) { if (item.key == key) { item.bounds = bounds; } }
+                });
+                return;
+            }
+            remove_from(key, old_cells);
+        }
+        for_each_cell(cells_for(bounds), [&](std::uint64_t cell)
+        {
+            cells[cell].push_back(item_type{ key, bounds });
+        });
+    }
+
+    /**
+     * Remove a key
+     * \return false if the key isn't in the grid
+     */
+    bool erase(const Key & key)
+    {
+        const auto entry = entries.find(key);
+        if (entry == entries.end()) { return false; }
+        remove_from(key, cells_for(entry->second));
+        entries.erase(entry);
+        return true;
+    }
+
+    bool contains(const Key & key) const { return entries.contains(key); }
+
+    /** Remove every key */
+    void clear() noexcept
+    {
+        entries.clear();
+        cells.clear();
+    }
+
+    /**
+     * Visit every key whose bounds intersect a region
+     * \param region the region to search
+     * \param visit a function to call with each key that's found
+     */
+    template<std::invocable<const Key &> Visitor>
+    void query(const bounds_type & region, Visitor && visit) const
+    {
+        const cell_range searched = cells_for(region);
+        for (std::int64_t y = searched.first_y; y <= searched.last_y; ++y)
+        {
+            for (std::int64_t x = searched.first_x; x <= searched.last_x; ++x)
+            {
+                const auto cell = cells.find(cell_key(x, y));
+                if (cell == cells.end()) { continue; }
+                for (const auto & item : cell->second)
+                {
+                    // a key that spans several searched cells is only visited from the first one
+                    const cell_range spanned = cells_for(item.bounds);
+                    if (std::max(spanned.first_x, searched.first_x) != x or
+                        std::max(spanned.first_y, searched.first_y) != y)
+                    {
+                        continue;
+                    }
+                    if (item.bounds.intersects(region)) { visit(item.key); }
+                }
+            }
+        }
+    }
+
+    size_type size() const noexcept { return entries.size(); }
+    bool empty() const noexcept { return entries.empty(); }
+
+    /** The number of cells that have something in them */
+    size_type num_cells() const noexcept { return cells.size(); }
+private:
+    struct item_type {
+        Key key;
+        bounds_type bounds;
+    };
+    struct cell_range {
+        std::int64_t first_x, first_y, last_x, last_y;
+        constexpr bool operator==(const cell_range &) const = default;
+    };
+
+    std::int64_t cell_of(Scalar value) const noexcept
+    {
+        if constexpr (std::is_integral_v<Scalar>)
+        {
+            // round towards negative infinity, so that negative coordinates get their own cells
+            const auto quotient = static_cast<std::int64_t>(value/cell_size);
+            return (value % cell_size != 0 and value < 0)? quotient - 1 : quotient;
+        }
+        else
+        {
+            return static_cast<std::int64_t>(std::floor(value/cell_size));
+        }
+    }
+
+    cell_range cells_for(const bounds_type & bounds) const noexcept
+    {
+        // the far edges are exclusive, so only step back from them when there's room to
+        Scalar right = bounds.x + bounds.w;
+        Scalar bottom = bounds.y + bounds.h;
+        if constexpr (std::is_integral_v<Scalar>)
+        {
+            right = std::max<Scalar>(right - 1, bounds.x);
+            bottom = std::max<Scalar>(bottom - 1, bounds.y);
+        }
+        return cell_range{ cell_of(bounds.x), cell_of(bounds.y),
+                           std::max(cell_of(right), cell_of(bounds.x)),
+                           std::max(cell_of(bottom), cell_of(bounds.y)) };
+    }
+
+    static std::uint64_t cell_key(std::int64_t x, std::int64_t y) noexcept
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32)
+             | static_cast<std::uint32_t>(y);
+    }
+
+    template<typename Visitor>
+    static void for_each_cell(const cell_range & range, Visitor && visit)
+    {
+        for (std::int64_t y = range.first_y; y <= range.last_y; ++y)
+        {
+            for (std::int64_t x = range.first_x; x <= range.last_x; ++x) { visit(cell_key(x, y)); }
+        }
+    }
+
+    void remove_from(const Key & key, const cell_range & range)
+    {
+        for_each_cell(range, [&](std::uint64_t cell_id)
+        {
+            const auto cell = cells.find(cell_id);
+            if (cell == cells.end()) { return; }
+            std::erase_if(cell->second, [&](const item_type & item) { return item.key == key; });
+            if (cell->second.empty()) { cells.erase(cell); }
+        });
+    }
+
+    Scalar cell_size;
+    std::unordered_map<Key, bounds_type> entries;
+    std::unordered_map<std::uint64_t, std::vector<item_type>> cells;
+};
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+namespace ion
+{
+
+/**
+ * A lock-free, fixed-size queue for handing values from one producer thread to one consumer
+ * thread. Only one thread may push and only one thread may pop.
+ */
+template<typename T, std::size_t Capacity>
+requires (std::has_single_bit(Capacity))
+class spsc_queue {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /**
+     * Push a value onto the back of the queue - only call from the producer thread
+     * \return false if the queue is full
+     */
+    bool push(const T & value) noexcept
+    {
+        const size_type tail = back.load(std::memory_order_relaxed);
+        if (tail - front.load(std::memory_order_acquire) == Capacity) { return false; }
+
+        slots[tail & mask] = value;
+        back.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop a value from the front of the queue - only call from the consumer thread
+     * \return false if the queue is empty
+     */
+    bool pop(T & value) noexcept
+    {
+        const size_type head = front.load(std::memory_order_relaxed);
+        if (head == back.load(std::memory_order_acquire)) { return false; }
+
+        value = slots[head & mask];
+        front.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** The number of values in the queue, as seen from the calling thread */
+    size_type size() const noexcept
+    {
+        return back.load(std::memory_order_acquire) - front.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    static constexpr size_type capacity() { return Capacity; }
+private:
+    static constexpr size_type mask = Capacity - 1;
+    static constexpr size_type cache_line_size = 64;
+
+    // the indices only ever increase, and are wrapped into the slots when used
+    alignas(cache_line_size) std::atomic<size_type> front{ 0 };
+    alignas(cache_line_size) std::atomic<size_type> back{ 0 };
+    alignas(cache_line_size) std::array<T, Capacity> slots{};
+};
+}
@@ -1,4 +1,19 @@
 #pragma once
 
 #include "ion/engine/sdl_resources.hpp"
-#include "ion/engine/sdl_events.hpp"
\ No newline at end of file
+#include "ion/engine/sdl_events.hpp"
+#include "ion/engine/session.hpp"
+#include "ion/engine/dispatch_profiler.hpp"
+#include "ion/engine/asset_loader.hpp"
+#include "ion/engine/resource_cache.hpp"
+#include "ion/engine/quad_geometry.hpp"
+#include "ion/engine/texture_atlas.hpp"
+#include "ion/engine/tilemap_renderer.hpp"
+#include "ion/engine/quad_batch.hpp"
+#include "ion/engine/dirty_region.hpp"
+#include "ion/engine/blit_cache.hpp"
+#include "ion/engine/tint_blit.hpp"
+#include "ion/engine/soft_raster.hpp"
+#include "ion/engine/chunked_tile_layer.hpp"
+#include "ion/engine/frame_pipeline.hpp"
+#include "ion/engine/run_loop.hpp"
\ No newline at end of file
@@ -0,0 +1,239 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <SDL3/SDL_pixels.h>
+
+#include "ion/engine/sdl_resources.hpp"
+
+namespace ion
+{
+enum class asset_status : std::uint8_t
+{
+    queued,     // waiting for a worker
+    decoding,   // being decoded by a worker
+    decoded,    // the surface is ready, and a texture is waiting to be uploaded
+    uploaded,   // the texture is ready
+    failed,     // the asset couldn't be decoded or uploaded
+    cancelled   // the request was cancelled before it was decoded
+};
+
+/** How a surface should be prepared after it's decoded */
+struct surface_params
+{
+    /** The pixel format to convert the surface to, or unknown to keep the decoded format */
+    SDL_PixelFormat format = SDL_PIXELFORMAT_UNKNOWN;
+
+    constexpr bool operator==(const surface_params &) const = default;
+};
+
+namespace internal
+{
+struct asset_request
+{
+    std::string path;
+    surface_params params;
+    int priority = 0;
+    std::uint64_t sequence = 0;
+    bool wants_texture = false;
+
+    std::atomic<asset_status> status = asset_status::queued;
+    sdl_surface surface;
+    sdl_texture texture;
+};
+}
+
+/**
+ * A handle to an asset that's being loaded by an asset_loader
+ *
+ * Handles share ownership of the loaded asset, which lives as long as any handle to it. When
+ * every handle to a queued request is dropped, the request is skipped.
+ */
+template<typename Asset>
+class asset_handle
+{
+public:
+    asset_handle() = default;
+
+    /** The loaded asset, or nullptr if it isn't ready */
+    Asset * get() const;
+
+    asset_status status() const { return request? request->status.load() : asset_status::failed; }
+    bool is_ready() const { return get() != nullptr; }
+
+    /** Determine if the request has finished, whether or not it was successful */
+    bool is_done() const;
+
+    /**
+     * Block until a worker is done decoding the asset
+     *
+     * Textures are uploaded on the render thread, so this only waits for the surface to decode
+     * when waiting for a texture.
+     */
+    void wait() const;
+
+    /**
+     * Cancel the request if a worker hasn't started on it yet
+     * \return false if the request had already been started
+     */
+    bool cancel();
+
+    std::string_view path() const { return request? std::string_view{ request->path } : std::string_view{}; }
+    explicit operator bool() const { return request != nullptr; }
+
+    /** The number of handles that share this asset */
+    long use_count() const { return request.use_count(); }
+private:
+    friend class asset_loader;
+    explicit asset_handle(std::shared_ptr<internal::asset_request> request)
+        : request{ std::move(request) }
+    {
+    }
+    std::shared_ptr<internal::asset_request> request;
+};
+
+using surface_handle = asset_handle<SDL_Surface>;
+using texture_handle = asset_handle<SDL_Texture>;
+
+/**
+ * Loads bitmaps asynchronously
+ *
+ * Surfaces are decoded on a pool of worker threads, highest priority first and in request
+ * order otherwise. Textures are decoded the same way, then uploaded by upload on the render
+ * thread in bounded batches, so a frame never stalls on a large set of uploads.
+ */
+class asset_loader
+{
+public:
+    /**
+     * Start a pool of workers
+     * \param num_workers the number of decode threads - defaults to one less than the number
+     *                    of hardware threads, and is always at least one
+     */
+    explicit asset_loader(std::size_t num_workers = default_num_workers());
+    ~asset_loader();
+
+    asset_loader(const asset_loader &) = delete;
+    asset_loader & operator=(const asset_loader &) = delete;
+
+    /**
+     * Decode a bitmap into a surface on a worker thread
+     * \param path where the bitmap is
+     * \param priority requests with a higher priority are decoded first
+     * \param params how to prepare the surface once it's decoded
+     */
+    surface_handle load_surface(std::string_view path, int priority = 0, const surface_params & params = {});
+
+    /**
+     * Decode a bitmap on a worker thread, and upload it to a texture in upload
+     * \param path where the bitmap is
+     * \param priority requests with a higher priority are decoded first
+     */
+    texture_handle load_texture(std::string_view path, int priority = 0);
+
+    /**
+     * Upload decoded textures - only call from the thread that owns the renderer
+     *
+     * Each uploaded texture frees its surface.
+     *
+     * \param renderer the renderer to create textures with
+     * \param max_uploads the most textures to upload in this call
+     * \return the number of textures that were uploaded
+     */
+    std::size_t upload(SDL_Renderer * renderer, std::size_t max_uploads);
+
+    /** The number of requests that are waiting to be decoded or uploaded */
+    std::size_t num_pending() const;
+
+    static std::size_t default_num_workers();
+private:
+    std::shared_ptr<internal::asset_request> enqueue(std::string_view path, int priority,
+                                                     const surface_params & params, bool wants_texture);
+    void decode_requests(std::stop_token stop);
+
+    struct decode_order
+    {
+        using request_ptr = std::shared_ptr<internal::asset_request>;
+        bool operator()(const request_ptr & lhs, const request_ptr & rhs) const;
+    };
+
+    mutable std::mutex queue_mutex;
+    std::condition_variable_any queue_changed;
+    std::priority_queue<std::shared_ptr<internal::asset_request>,
+                        std::vector<std::shared_ptr<internal::asset_request>>,
+                        decode_order> decode_queue;
+    std::uint64_t num_requests = 0;
+
+    mutable std::mutex upload_mutex;
+    std::deque<std::shared_ptr<internal::asset_request>> upload_queue;
+
+    std::vector<std::jthread> workers;
+};
+}
+
+template<typename Asset>
+Asset * ion::asset_handle<Asset>::get() const
+{
+    if (not request) { return nullptr; }
+    if constexpr (std::is_same_v<Asset, SDL_Texture>)
+    {
+        return request->status.load(std::memory_order_acquire) == asset_status::uploaded
+             ? request->texture.get() : nullptr;
+    }
+    else
+    {
+        return request->status.load(std::memory_order_acquire) == asset_status::decoded
+             ? request->surface.get() : nullptr;
+    }
+}
+
+template<typename Asset>
+bool ion::asset_handle<Asset>::is_done() const
+{
+    switch (status())
+    {
+    case asset_status::queued:
+    case asset_status::decoding:
+        return false;
+    case asset_status::decoded:
+        return not std::is_same_v<Asset, SDL_Texture>;
+    default:
+        return true;
+    }
+}
+
+template<typename Asset>
+void ion::asset_handle<Asset>::wait() const
+{
+    if (not request) { return; }
+    for (auto status = request->status.load(std::memory_order_acquire);
+         status == asset_status::queued or status == asset_status::decoding;
+         status = request->status.load(std::memory_order_acquire))
+    {
+        request->status.wait(status, std::memory_order_acquire);
+    }
+}
+
+template<typename Asset>
+bool ion::asset_handle<Asset>::cancel()
+{
+    if (not request) { return false; }
+    auto expected = asset_status::queued;
+    if (not request->status.compare_exchange_strong(expected, asset_status::cancelled))
+    {
+        return false;
+    }
+    request->status.notify_all();
+    return true;
+}
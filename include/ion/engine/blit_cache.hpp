@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <SDL3/SDL_pixels.h>
+
+#include "ion/engine/sdl_resources.hpp"
+
+namespace ion
+{
+/**
+ * A cache of surfaces that have been prepared to blit onto one destination format
+ *
+ * Each source surface is converted once to the destination format - or to the same layout
+ * with an alpha channel, if the source has alpha - then scaled and rotated to each size and
+ * rotation it's asked for. Blitting a prepared surface at its own size is then a plain copy
+ * or a same-layout blend, which SDL has fast paths for, instead of a conversion and rescale.
+ *
+ * The cache holds a reference to each source surface, so a source stays alive while it has
+ * prepared variants. Variants are never evicted on their own: clear the cache when the sizes
+ * being drawn change, like when a window is resized.
+ */
+class blit_cache
+{
+public:
+    blit_cache() = default;
+    ~blit_cache();
+
+    blit_cache(const blit_cache &) = delete;
+    blit_cache & operator=(const blit_cache &) = delete;
+
+    /** Set the format of the surface being blitted to - changing it clears the cache */
+    void format(SDL_PixelFormat destination_format);
+    SDL_PixelFormat format() const { return destination_format; }
+
+    /**
+     * Get a surface prepared to blit to the destination format
+     *
+     * \param source the surface to prepare
+     * \param width the width to scale the surface to, after it's rotated
+     * \param height the height to scale the surface to, after it's rotated
+     * \param quarter_turns how many times to rotate the surface a quarter turn clockwise
+     * \return the prepared surface, or nullptr if it couldn't be prepared
+     */
+    SDL_Surface * prepared(SDL_Surface * source, int width, int height, int quarter_turns = 0);
+
+    /** Map a color to a pixel value in the destination format */
+    std::uint32_t map(const SDL_Color & color);
+
+    /** Forget every prepared surface and mapped color */
+    void clear();
+
+    /** The number of prepared surfaces */
+    std::size_t size() const { return variants.size(); }
+private:
+    struct variant_key
+    {
+        SDL_Surface * source;
+        int width, height, quarter_turns;
+        bool operator==(const variant_key &) const = default;
+    };
+    struct variant_hash
+    {
+        std::size_t operator()(const variant_key & key) const noexcept;
+    };
+
+    SDL_PixelFormat destination_format = SDL_PIXELFORMAT_UNKNOWN;
+    std::unordered_map<variant_key, sdl_surface, variant_hash> variants;
+    std::unordered_map<std::uint32_t, std::uint32_t> mapped_colors;
+};
+}
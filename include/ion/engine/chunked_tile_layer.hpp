@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_render.h>
+
+#include "ion/engine/sdl_resources.hpp"
+#include "ion/engine/texture_atlas.hpp"
+
+namespace ion
+{
+/**
+ * A layer of tiles that rarely change, baked into a texture per chunk
+ *
+ * The layer is a grid of cells, grouped into square chunks of chunk_tiles by chunk_tiles
+ * cells. Each chunk is drawn into its own render target texture the first time it's visible
+ * after its cells change, so a steady frame draws one textured quad per visible chunk no
+ * matter how many tiles are in it. Cells are drawn as a solid fill with a tile from the atlas
+ * over it, and chunks are transparent where there aren't any cells.
+ *
+ * Grid coordinates grow right and down, like render coordinates.
+ */
+class chunked_tile_layer
+{
+public:
+    /**
+     * Create an empty layer
+     * \param tile_size the width and height of a cell in pixels
+     * \param chunk_tiles the width and height of a chunk in cells
+     */
+    explicit chunked_tile_layer(int tile_size = 16, int chunk_tiles = 16);
+
+    /** Set the atlas to draw tiles from - every chunk is baked again when it changes */
+    void atlas(const texture_atlas * atlas);
+    const texture_atlas * atlas() const { return tile_atlas; }
+
+    /** Set the size of a cell in pixels - every chunk is baked again when it changes */
+    void tile_size(int size);
+    int tile_size() const { return cell_size; }
+
+    /**
+     * Set a cell, replacing what was there
+     * \param x the column of the cell
+     * \param y the row of the cell
+     * \param tile the id the tile was added to the atlas with
+     * \param fill the color to fill the cell with under the tile
+     */
+    void place(int x, int y, std::uint32_t tile, const SDL_Color & fill);
+
+    /** Empty a cell */
+    void erase(int x, int y);
+
+    /** Empty every cell and free every chunk's texture */
+    void clear();
+
+    /** Bake every chunk again, like after the renderer's targets have been reset */
+    void invalidate();
+
+    /**
+     * Draw every chunk that overlaps the current render output
+     *
+     * Chunks that changed since they were last drawn are baked first, and the render target
+     * is restored after.
+     *
+     * \param renderer the renderer to draw with
+     * \param origin where the upper left corner of cell 0, 0 is drawn
+     */
+    void render(SDL_Renderer * renderer, const SDL_FPoint & origin);
+
+    /** The number of cells that have a tile */
+    std::size_t size() const { return num_cells; }
+
+    /** The number of chunks that have at least one cell */
+    std::size_t num_chunks() const { return chunks.size(); }
+private:
+    struct cell
+    {
+        std::uint32_t tile;
+        SDL_Color fill;
+        bool is_set;
+    };
+    struct chunk
+    {
+        std::vector<cell> cells;
+        std::size_t num_set = 0;
+        sdl_texture texture;
+        bool is_dirty = true;
+    };
+    static std::uint64_t chunk_key(int chunk_x, int chunk_y);
+    bool bake(SDL_Renderer * renderer, chunk & baked);
+
+    const texture_atlas * tile_atlas = nullptr;
+    int cell_size;
+    int chunk_tiles;
+    std::size_t num_cells = 0;
+    std::unordered_map<std::uint64_t, chunk> chunks;
+
+    // geometry for baking a chunk, kept between bakes
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL_rect.h>
+
+namespace ion
+{
+/**
+ * Tracks the parts of a surface that need to be redrawn
+ *
+ * Marked rects are clipped to the bounds, and rects that overlap are merged, so the region
+ * never redraws a pixel twice. When there would be more than the maximum number of rects, the
+ * new rect is merged into whichever one grows the least, which keeps the number of redraws and
+ * presented rects bounded.
+ */
+class dirty_region
+{
+public:
+    static constexpr std::size_t default_max_rects = 16;
+
+    explicit dirty_region(std::size_t max_rects = default_max_rects);
+
+    /** Set the area that can be marked - changing the bounds marks all of them */
+    void bounds(const SDL_Rect & bounds);
+    const SDL_Rect & bounds() const { return area; }
+
+    /** Mark a rect as needing to be redrawn */
+    void mark(const SDL_Rect & rect);
+
+    /** Mark everything within the bounds as needing to be redrawn */
+    void mark_all();
+
+    /** The rects that need to be redrawn, which don't overlap */
+    std::span<const SDL_Rect> rects() const { return dirty_rects; }
+
+    bool empty() const { return dirty_rects.empty(); }
+
+    /** Forget every marked rect, once they've been redrawn */
+    void clear() { dirty_rects.clear(); }
+private:
+    std::size_t max_rects;
+    SDL_Rect area{ 0, 0, 0, 0 };
+    std::vector<SDL_Rect> dirty_rects;
+};
+}
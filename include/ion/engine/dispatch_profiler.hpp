@@ -0,0 +1,265 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_timer.h>
+#include <entt/config/config.h>
+#include <entt/signal/delegate.hpp>
+#include <entt/signal/sigh.hpp>
+
+namespace ion
+{
+/** How often one listener was called, and how long it took */
+struct listener_profile
+{
+    std::string_view listener;
+    std::string_view event;
+    std::uint64_t calls = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+};
+
+/**
+ * Opt-in profiling of the listeners connected to the sdl_events sinks
+ *
+ * A listener connected through an event_sink while the profiler is enabled is called through
+ * a wrapper, which records how many times the listener was called, and its cumulative and
+ * maximum time. Listeners connected while the profiler is disabled are connected directly,
+ * so they cost nothing extra and are never profiled - enable the profiler before connecting
+ * the listeners that should be timed. A wrapper only forwards the call while the profiler
+ * is disabled.
+ */
+class dispatch_profiler
+{
+public:
+    static void enable(bool enabled);
+    static bool is_enabled();
+
+    /** The profile of every listener that has been profiled, slowest in total first */
+    static std::vector<listener_profile> table();
+
+    /** Log the profile table */
+    static void dump();
+
+    /**
+     * Log the profile table periodically
+     * \param num_polls how many polls to wait between each dump, or zero to stop dumping
+     */
+    static void dump_every(std::uint32_t num_polls);
+
+    /** Clear every profile, and forget the listeners that have been disconnected */
+    static void reset();
+
+    /** Count a poll for the periodic dump - sdl_events calls this at the end of each poll */
+    static void end_poll();
+};
+
+namespace internal
+{
+struct profiled_listener
+{
+    virtual ~profiled_listener() = default;
+
+    /** Disconnect the listener's wrapper from its signal */
+    virtual void disconnect() = 0;
+
+    listener_profile profile;
+    std::uint64_t id = 0;
+    const void * signal = nullptr;
+    const void * instance = nullptr;
+    bool is_connected = true;
+
+    // how many calls to the listener are running right now, which keeps a listener that
+    // disconnects itself from being freed while it's being called
+    std::uint32_t active_calls = 0;
+};
+
+template<typename... Args>
+struct timed_listener : profiled_listener
+{
+    using signal_type = entt::sigh<void(Args...)>;
+
+    entt::delegate<void(Args...)> target;
+    signal_type * connected_signal = nullptr;
+
+    void disconnect() override
+    {
+        entt::sink{ *connected_signal }.disconnect(this);
+    }
+
+    static void call(timed_listener & listener, Args... args)
+    {
+        ++listener.active_calls;
+        if (not dispatch_profiler::is_enabled())
+        {
+            listener.target(args...);
+            --listener.active_calls;
+            return;
+        }
+        const std::uint64_t start = SDL_GetTicksNS();
+        listener.target(args...);
+        const std::uint64_t elapsed = SDL_GetTicksNS() - start;
+        --listener.active_calls;
+
+        auto & profile = listener.profile;
+        ++profile.calls;
+        profile.total_ns += elapsed;
+        profile.max_ns = std::max(profile.max_ns, elapsed);
+    }
+};
+
+profiled_listener & track(std::unique_ptr<profiled_listener> listener);
+void forget(std::uint64_t id);
+void forget(const void * signal, std::string_view listener, const void * instance);
+void forget_all(const void * signal, const void * instance);
+void forget_all(const void * signal);
+
+/** A readable name for a listener function */
+template<auto Candidate>
+std::string_view listener_name()
+{
+    const std::string_view signature = ENTT_PRETTY_FUNCTION;
+
+    // gcc and clang spell out the template argument as "Candidate = <name>" followed by
+    // ';' or ']', and msvc puts it in angle brackets after the function name
+    constexpr std::string_view argument_prefix = "Candidate = ";
+    constexpr std::string_view template_prefix = "listener_name<";
+    if (const auto start = signature.find(argument_prefix); start != std::string_view::npos)
+    {
+        const auto name = signature.substr(start + argument_prefix.size());
+        return name.substr(0, name.find_first_of(";]"));
+    }
+    if (const auto start = signature.find(template_prefix); start != std::string_view::npos)
+    {
+        const auto name = signature.substr(start + template_prefix.size());
+        return name.substr(0, name.rfind(">("));
+    }
+    return signature;
+}
+
+inline const void * instance_of()
+{
+    return nullptr;
+}
+
+template<typename Type>
+const void * instance_of(Type && value_or_instance)
+{
+    if constexpr (std::is_pointer_v<std::remove_cvref_t<Type>>) { return value_or_instance; }
+    else { return std::addressof(value_or_instance); }
+}
+}
+
+/**
+ * A connection to an event_sink, which works like an entt::connection but also stops the
+ * dispatch_profiler from tracking the listener when it's released
+ */
+class event_connection
+{
+public:
+    event_connection() = default;
+    event_connection(entt::connection connection, std::uint64_t profiled_id = 0)
+        : connection{ std::move(connection) }, profiled_id{ profiled_id }
+    {
+    }
+
+    /** Determine if the connection is still connected */
+    explicit operator bool() const { return static_cast<bool>(connection); }
+
+    /** Disconnect the listener from its signal */
+    void release();
+private:
+    entt::connection connection;
+    std::uint64_t profiled_id = 0;
+};
+
+/**
+ * A sink for an sdl_events signal, which is an entt::sink whose listeners can be profiled by
+ * the dispatch_profiler. Connecting and disconnecting listeners works like it does for
+ * entt::sink, and connecting returns an event_connection rather than an entt::connection.
+ */
+template<typename Signal>
+class event_sink;
+
+template<typename... Args>
+class event_sink<entt::sigh<void(Args...)>> : public entt::sink<entt::sigh<void(Args...)>>
+{
+public:
+    using signal_type = entt::sigh<void(Args...)>;
+
+    event_sink(signal_type & signal, std::string_view event)
+        : entt::sink<signal_type>{ signal }, signal{ &signal }, event{ event }
+    {
+    }
+
+    template<auto Candidate, typename... Type>
+    event_connection connect(Type &&... value_or_instance);
+
+    template<auto Candidate, typename... Type>
+    void disconnect(Type &&... value_or_instance);
+
+    template<typename Type>
+    void disconnect(Type && value_or_instance);
+
+    /** Disconnect every listener */
+    void disconnect();
+private:
+    signal_type * signal;
+    std::string_view event;
+};
+
+template<typename... Args>
+event_sink(entt::sigh<void(Args...)> &, std::string_view) -> event_sink<entt::sigh<void(Args...)>>;
+}
+
+template<typename... Args>
+template<auto Candidate, typename... Type>
+ion::event_connection ion::event_sink<entt::sigh<void(Args...)>>::connect(Type &&... value_or_instance)
+{
+    // like entt, a listener that's connected again replaces its old connection
+    disconnect<Candidate>(value_or_instance...);
+    if (not dispatch_profiler::is_enabled())
+    {
+        return entt::sink<signal_type>::template connect<Candidate>(std::forward<Type>(value_or_instance)...);
+    }
+
+    // call the listener through a wrapper that can time it
+    using listener_type = internal::timed_listener<Args...>;
+    auto listener = std::make_unique<listener_type>();
+    listener->target.template connect<Candidate>(value_or_instance...);
+    listener->profile = { internal::listener_name<Candidate>(), event };
+    listener->signal = signal;
+    listener->instance = internal::instance_of(value_or_instance...);
+    listener->connected_signal = signal;
+
+    auto & tracked = static_cast<listener_type &>(internal::track(std::move(listener)));
+    return { entt::sink<signal_type>::template connect<&listener_type::call>(tracked), tracked.id };
+}
+
+template<typename... Args>
+template<auto Candidate, typename... Type>
+void ion::event_sink<entt::sigh<void(Args...)>>::disconnect(Type &&... value_or_instance)
+{
+    internal::forget(signal, internal::listener_name<Candidate>(), internal::instance_of(value_or_instance...));
+    entt::sink<signal_type>::template disconnect<Candidate>(value_or_instance...);
+}
+
+template<typename... Args>
+template<typename Type>
+void ion::event_sink<entt::sigh<void(Args...)>>::disconnect(Type && value_or_instance)
+{
+    internal::forget_all(signal, internal::instance_of(value_or_instance));
+    entt::sink<signal_type>::disconnect(std::forward<Type>(value_or_instance));
+}
+
+template<typename... Args>
+void ion::event_sink<entt::sigh<void(Args...)>>::disconnect()
+{
+    internal::forget_all(signal);
+    entt::sink<signal_type>::disconnect();
+}
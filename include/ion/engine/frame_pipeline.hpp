@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ion
+{
+/**
+ * A triple buffer that hands render snapshots from a simulation thread to a render thread
+ *
+ * The simulation fills back() and publishes it, while the renderer draws front(). Publishing
+ * swaps the back buffer with the one waiting to be consumed, and consuming swaps the front
+ * buffer with it, so neither thread ever touches a buffer the other is using, and buffers are
+ * reused rather than reallocated. Snapshots should be compact - what the renderer needs to
+ * draw, like transforms, colors and texture ids, rather than the simulation's own state.
+ *
+ * With bounded latency, publish waits until the last snapshot has been consumed, so the
+ * simulation can't run more than a frame ahead of what's on screen. Without it, publish never
+ * waits and the renderer always gets the newest snapshot, skipping any it didn't get to.
+ */
+template<typename Snapshot>
+class frame_pipeline
+{
+public:
+    explicit frame_pipeline(bool bounded_latency = true)
+        : bounded_latency{ bounded_latency }
+    {
+    }
+
+    frame_pipeline(const frame_pipeline &) = delete;
+    frame_pipeline & operator=(const frame_pipeline &) = delete;
+
+    /** The snapshot to fill in - only use from the simulation thread */
+    Snapshot & back() { return slots[write_index]; }
+
+    /**
+     * Hand the back snapshot to the renderer - only call from the simulation thread
+     * \return false if the pipeline was stopped, in which case nothing is published
+     */
+    bool publish()
+    {
+        std::uint32_t state = shared.load(std::memory_order_acquire);
+        while (true)
+        {
+            if (state & stopped_bit) { return false; }
+            if (bounded_latency and (state & fresh_bit))
+            {
+                shared.wait(state, std::memory_order_acquire);
+                state = shared.load(std::memory_order_acquire);
+                continue;
+            }
+            if (shared.compare_exchange_weak(state, write_index | fresh_bit,
+                                             std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                break;
+            }
+        }
+        write_index = state & index_mask;
+        shared.notify_all();
+        return true;
+    }
+
+    /** The snapshot to draw - only use from the render thread */
+    const Snapshot & front() const { return slots[read_index]; }
+
+    /**
+     * Take the newest published snapshot, if there is one - only call from the render thread
+     * \return true if front is a new snapshot
+     */
+    bool consume()
+    {
+        std::uint32_t state = shared.load(std::memory_order_acquire);
+        while (state & fresh_bit)
+        {
+            if (shared.compare_exchange_weak(state, read_index | (state & stopped_bit),
+                                             std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                read_index = state & index_mask;
+                shared.notify_all();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Wait for a new snapshot and take it - only call from the render thread
+     * \return false if the pipeline was stopped before a snapshot was published
+     */
+    bool wait_consume()
+    {
+        while (not consume())
+        {
+            const std::uint32_t state = shared.load(std::memory_order_acquire);
+            if (state & stopped_bit) { return false; }
+            if (not (state & fresh_bit)) { shared.wait(state, std::memory_order_acquire); }
+        }
+        return true;
+    }
+
+    /** Wake up and turn away both threads for good, like when shutting down */
+    void stop()
+    {
+        shared.fetch_or(stopped_bit, std::memory_order_acq_rel);
+        shared.notify_all();
+    }
+
+    bool is_stopped() const { return shared.load(std::memory_order_acquire) & stopped_bit; }
+private:
+    // the shared state is the index of the snapshot waiting between the threads, whether it's
+    // been published since it was last consumed, and whether the pipeline has been stopped
+    static constexpr std::uint32_t index_mask = 0b0011;
+    static constexpr std::uint32_t fresh_bit = 0b0100;
+    static constexpr std::uint32_t stopped_bit = 0b1000;
+
+    std::array<Snapshot, 3> slots;
+    std::uint32_t write_index = 0;
+    std::uint32_t read_index = 2;
+    std::atomic<std::uint32_t> shared = 1;
+    const bool bounded_latency;
+};
+}
\ No newline at end of file
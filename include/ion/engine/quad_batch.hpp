@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <SDL3/SDL_blendmode.h>
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_render.h>
+
+namespace ion
+{
+/**
+ * Collects colored and textured quads, and draws them with as few calls as possible
+ *
+ * Quads are grouped by texture and blend mode as they're pushed, and flush draws each group
+ * with a single SDL_RenderGeometry call, in order of texture and blend mode. Quads keep
+ * their submission order within a group, but not across groups - quads that need to be
+ * layered over quads from another group should be flushed separately. The buffers are kept
+ * between flushes, so a steady frame doesn't allocate.
+ */
+class quad_batch
+{
+public:
+    /** Queue a solid quad */
+    void push(const SDL_FRect & dst, const SDL_Color & color, SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND);
+
+    /**
+     * Queue a textured quad
+     * \param dst where to draw the quad
+     * \param texture the texture to draw, or nullptr for a solid quad
+     * \param uv the rect of the texture to draw, in normalized texture coordinates
+     * \param tint the color to modulate the texture with
+     * \param blend_mode how to blend the quad with what's under it
+     */
+    void push(const SDL_FRect & dst, SDL_Texture * texture, const SDL_FRect & uv,
+              const SDL_Color & tint = { 0xff, 0xff, 0xff, 0xff },
+              SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND);
+
+    /** Reserve room for a number of additional quads with a texture and blend mode */
+    void reserve(std::size_t num_quads, SDL_Texture * texture = nullptr,
+                 SDL_BlendMode blend_mode = SDL_BLENDMODE_BLEND);
+
+    /** Draw every queued quad and empty the batch */
+    void flush(SDL_Renderer * renderer);
+
+    /** Empty the batch without drawing it */
+    void clear();
+
+    /** The number of queued quads */
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+private:
+    struct group
+    {
+        SDL_Texture * texture;
+        SDL_BlendMode blend_mode;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+    group & group_for(SDL_Texture * texture, SDL_BlendMode blend_mode);
+
+    // there are only ever a handful of groups, so they're searched linearly
+    std::vector<group> groups;
+};
+}
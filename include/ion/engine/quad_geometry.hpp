@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_render.h>
+
+namespace ion
+{
+/** Convert an 8-bit color to the float color that vertices use */
+constexpr SDL_FColor to_fcolor(const SDL_Color & color)
+{
+    return { static_cast<float>(color.r)/255.f, static_cast<float>(color.g)/255.f,
+             static_cast<float>(color.b)/255.f, static_cast<float>(color.a)/255.f };
+}
+
+/**
+ * Append a quad as two triangles to a geometry buffer
+ *
+ * \param vertices the vertex buffer to append four corners to
+ * \param indices the index buffer to append six indices to
+ * \param dst the rect the quad covers, in render coordinates
+ * \param uv the rect of the texture to map onto the quad, in normalized texture coordinates
+ * \param color the color of every corner
+ */
+inline void push_quad(std::vector<SDL_Vertex> & vertices, std::vector<int> & indices,
+                      const SDL_FRect & dst, const SDL_FRect & uv, const SDL_FColor & color)
+{
+    const int first = static_cast<int>(vertices.size());
+    vertices.push_back({ { dst.x, dst.y }, color, { uv.x, uv.y } });
+    vertices.push_back({ { dst.x + dst.w, dst.y }, color, { uv.x + uv.w, uv.y } });
+    vertices.push_back({ { dst.x + dst.w, dst.y + dst.h }, color, { uv.x + uv.w, uv.y + uv.h } });
+    vertices.push_back({ { dst.x, dst.y + dst.h }, color, { uv.x, uv.y + uv.h } });
+
+    indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ion/engine/asset_loader.hpp"
+
+namespace ion
+{
+/**
+ * A cache of loaded surfaces, keyed by path and load parameters
+ *
+ * Loading the same surface twice hands back a handle to the same asset. Decoded surfaces are
+ * kept after the last handle to them is dropped, until the cache goes over its byte budget:
+ * then the least recently used surfaces that nobody holds a handle to are evicted. Surfaces
+ * that are still in use are never evicted, so the cache can stay over budget while they are.
+ */
+class resource_cache
+{
+public:
+    static constexpr std::size_t default_byte_budget = 256 << 20;
+
+    struct statistics
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+        std::size_t bytes = 0;
+        std::size_t num_entries = 0;
+    };
+
+    /**
+     * \param loader the loader to decode missing surfaces with
+     * \param byte_budget how many bytes of decoded surfaces to keep before evicting
+     */
+    explicit resource_cache(asset_loader & loader, std::size_t byte_budget = default_byte_budget);
+
+    /**
+     * Get a cached surface, or start loading it if it isn't cached
+     * \param path where the bitmap is
+     * \param params how the surface should be prepared
+     * \param priority the priority to load the surface with if it isn't cached
+     */
+    surface_handle load_surface(std::string_view path, const surface_params & params = {}, int priority = 0);
+
+    /** Change the byte budget, and evict surfaces until the cache fits in it */
+    void budget(std::size_t byte_budget);
+    std::size_t budget() const { return byte_budget; }
+
+    /** Evict unused surfaces until the cache fits in its budget */
+    void trim();
+
+    /** Evict every surface that isn't in use */
+    void clear();
+
+    /** The cache's hits, misses and evictions so far, and how much it holds right now */
+    statistics stats();
+    void reset_stats();
+private:
+    struct key
+    {
+        std::string path;
+        surface_params params;
+        bool operator==(const key &) const = default;
+    };
+    struct key_hash
+    {
+        std::size_t operator()(const key & k) const noexcept;
+    };
+    struct entry
+    {
+        key id;
+        surface_handle surface;
+        std::size_t bytes = 0;
+        bool is_sized = false;
+    };
+    using entry_list = std::list<entry>;
+
+    bool is_evictable(const entry & cached) const;
+    void evict(entry_list::iterator cached);
+    void measure_pending();
+    void evict_unused(std::size_t target_bytes);
+
+    asset_loader * loader;
+    std::size_t byte_budget;
+
+    // most recently used at the front
+    entry_list entries;
+    std::unordered_map<key, entry_list::iterator, key_hash> lookup;
+
+    // entries that were still loading the last time the cache was measured
+    std::vector<entry_list::iterator> unsized;
+
+    std::size_t num_bytes = 0;
+    std::uint64_t num_hits = 0;
+    std::uint64_t num_misses = 0;
+    std::uint64_t num_evictions = 0;
+};
+}
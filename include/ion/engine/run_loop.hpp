@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+
+struct SDL_Renderer;
+
+namespace ion
+{
+/**
+ * Paces a main loop, and decides when it needs to draw
+ *
+ * Each iteration calls wait, polls events, and draws if should_draw says to - or calls poll,
+ * which does all but the drawing, and polls through session::poll so the loop can be
+ * recorded and replayed. How the loop is paced depends on its mode:
+ *
+ * - continuous runs as fast as it can, drawing every iteration
+ * - vsync turns on vsync for a renderer, so presenting paces the loop
+ * - capped sleeps until the next frame is due, at most hz frames a second - it reads the time
+ *   and sleeps through the current time_source, so with virtual time it runs as fast as it
+ *   can while time moves forward a frame at a time
+ * - on_demand blocks until an event arrives or a redraw is requested, and only draws when
+ *   a window event arrived or request_redraw was called - so an idle loop uses no cpu
+ *
+ * An on demand loop doesn't block while a session is being replayed, since replayed events
+ * don't go through sdl's queue, and it draws every iteration of the replay.
+ */
+class run_loop
+{
+public:
+    enum class mode
+    {
+        continuous,
+        vsync,
+        capped,
+        on_demand
+    };
+
+    /** A loop that runs as fast as it can */
+    static run_loop continuous();
+
+    /**
+     * A loop that's paced by presenting with vsync
+     * \param renderer the renderer to turn vsync on for - if it can't be, the loop is capped to
+     *                 60 frames a second instead
+     */
+    static run_loop vsync(SDL_Renderer * renderer);
+
+    /**
+     * A loop that runs at most a number of times a second
+     * \param hz the most frames a second
+     */
+    static run_loop capped(double hz);
+
+    /**
+     * A loop that waits for events, and only draws when something has changed
+     * \param idle_timeout_ms the longest to wait for an event, or -1 to wait until one arrives
+     */
+    static run_loop on_demand(std::int32_t idle_timeout_ms = -1);
+
+    /**
+     * Ask on demand loops to draw on their next iteration - may be called from any thread
+     *
+     * Loops that are blocked waiting for events are woken up.
+     */
+    static void request_redraw();
+
+    /** Wait until the next iteration should start */
+    void wait();
+
+    /**
+     * Determine if this iteration should draw - call after polling events
+     *
+     * Continuous, vsync and capped loops always draw. On demand loops draw when a redraw was
+     * requested or a window event arrived since the last time this was called.
+     */
+    bool should_draw();
+
+    /**
+     * Wait for the next iteration, poll events through session::poll, and determine if it
+     * should draw
+     * \return whether the iteration should draw
+     */
+    bool poll();
+
+    /** The time in seconds to simulate the iteration that was last polled with */
+    float delta_time() const { return frame_dt; }
+
+    mode policy() const { return loop_mode; }
+private:
+    run_loop(mode loop_mode, std::uint64_t frame_period_ns, std::int32_t idle_timeout_ms);
+
+    mode loop_mode;
+    std::uint64_t frame_period_ns;
+    std::uint64_t next_frame_ns = 0;
+    std::int32_t idle_timeout_ms;
+    bool has_window_changed = true;
+    std::uint64_t last_poll_ns = 0;
+    float frame_dt = 0.f;
+};
+}
\ No newline at end of file
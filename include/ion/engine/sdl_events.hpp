@@ -1,27 +1,129 @@
 #pragma once
+#include <cstddef>
+#include <span>
 #include <entt/signal/sigh.hpp>
 #include <SDL3/SDL_events.h>
 
+#include "ion/engine/dispatch_profiler.hpp"
+
 namespace ion
 {
+/**
+ * A static hub that publishes sdl events to sinks
+ *
+ * Events are drained from sdl in batches and bucketed by type. Each poll calls the batch
+ * sinks first, once per bucket with a span of its events, and then calls the per-event sinks
+ * for every event in queue order.
+ *
+ * Listeners may poll or dispatch events themselves. Those events are published before the
+ * call returns, and the events of the poll the listener was called from carry on after.
+ *
+ * Mouse motion and mouse wheel events can be coalesced, so that the per-event sinks are
+ * called once per poll no matter how many events arrived. Listeners that need the raw stream
+ * can opt out by connecting to the batch sinks, which always get every event.
+ *
+ * Each listener that was connected while the dispatch_profiler is enabled is timed individually.
+ */
 class sdl_events
 {
 public:
+    /** The most events that are drained from sdl at once */
+    static constexpr std::size_t max_batch_size = 256;
+
+    /** Drain the sdl event queue and publish every event in it */
     static void poll();
-    static auto on_poll() { return entt::sink{ poll_signal }; }
-    static auto on_quit() { return entt::sink{ quit_signal }; }
-    static auto on_mouse_scroll() { return entt::sink{ mouse_scroll_signal }; }
-    static auto on_mouse_up() { return entt::sink{ mouse_up_signal }; }
-    static auto on_mouse_moved() { return entt::sink{ mouse_moved_signal }; }
-    static auto on_key_up() { return entt::sink{ key_up_signal }; }
-    static auto on_key_down() { return entt::sink{ key_down_signal }; }
+
+    /** Publish a batch of events as if they had been polled */
+    static void dispatch(std::span<const SDL_Event> events);
+
+    /**
+     * Set whether events of a type are merged into one event per poll for the per-event sinks
+     *
+     * Mouse motion collapses to the latest position with the relative motion summed, and mouse
+     * wheel events are summed. The merged event is published where the last of its events was
+     * in the queue. Coalescing is off for every type by default.
+     *
+     * \param type the type of event to coalesce
+     * \param enabled whether events of this type should be coalesced
+     * \return false if events of this type can't be coalesced
+     */
+    static bool coalesce(SDL_EventType type, bool enabled);
+
+    /** Determine if events of a type are coalesced */
+    static bool is_coalesced(SDL_EventType type);
+
+    /**
+     * Set whether event types that no sink observes are kept out of the sdl event queue
+     *
+     * When enabled, each poll checks which sinks have listeners and disables the event types
+     * nobody listens to with SDL_SetEventEnabled, so sdl never queues them. Every type that
+     * sdl defines and ion doesn't publish - window, display, joystick, gamepad, touch, text,
+     * drop and the rest - is only queued while a raw listener is connected to on_poll or
+     * on_event_batch. Quit events, sdl's reserved events, the events a program registers
+     * and the types passed to observe are always queued. Changes to the connected listeners take effect at the start of the
+     * next poll.
+     *
+     * \param enabled whether unobserved event types should be filtered out
+     */
+    static void filter_unobserved(bool enabled);
+
+    /** Determine if event types that no sink observes are kept out of the event queue */
+    static bool filters_unobserved();
+
+    /**
+     * Set whether a type of event is observed even though no sink listens to it
+     *
+     * Observed types are kept in the sdl event queue while unobserved types are filtered out,
+     * for code that reads sdl's queue itself rather than listening to a sink.
+     *
+     * \param type the type of event to observe
+     * \param observed whether events of this type should be kept in the queue
+     */
+    static void observe(SDL_EventType type, bool observed);
+
+    /** Determine if a type of event is observed even though no sink listens to it */
+    static bool is_observed(SDL_EventType type);
+
+    /** Throw away every event that's waiting to be polled */
+    static void flush();
+
+    static auto on_poll() { return event_sink{ poll_signal, "poll" }; }
+    static auto on_quit() { return event_sink{ quit_signal, "quit" }; }
+    static auto on_mouse_scroll() { return event_sink{ mouse_scroll_signal, "mouse-scroll" }; }
+    static auto on_mouse_up() { return event_sink{ mouse_up_signal, "mouse-up" }; }
+    static auto on_mouse_moved() { return event_sink{ mouse_moved_signal, "mouse-moved" }; }
+    static auto on_mouse_motion() { return event_sink{ mouse_motion_signal, "mouse-motion" }; }
+    static auto on_key_up() { return event_sink{ key_up_signal, "key-up" }; }
+    static auto on_key_down() { return event_sink{ key_down_signal, "key-down" }; }
+
+    static auto on_event_batch() { return event_sink{ event_batch_signal, "event-batch" }; }
+    static auto on_mouse_moved_batch() { return event_sink{ mouse_moved_batch_signal, "mouse-moved-batch" }; }
+    static auto on_mouse_button_batch() { return event_sink{ mouse_button_batch_signal, "mouse-button-batch" }; }
+    static auto on_mouse_scroll_batch() { return event_sink{ mouse_scroll_batch_signal, "mouse-scroll-batch" }; }
+    static auto on_key_batch() { return event_sink{ key_batch_signal, "key-batch" }; }
+
+    /** Called at the end of every poll or dispatch, once every other sink has been called */
+    static auto on_polled() { return event_sink{ polled_signal, "polled" }; }
+
+    struct event_buffers;
 private:
+    static void refresh_event_filter();
+    static void publish(event_buffers & buffers);
+
     static entt::sigh<void(SDL_Event*)> poll_signal;
     static entt::sigh<void()> quit_signal;
     static entt::sigh<void(int)> mouse_scroll_signal;
     static entt::sigh<void()> mouse_up_signal;
     static entt::sigh<void(int, int)> mouse_moved_signal;
+    static entt::sigh<void(const SDL_MouseMotionEvent &)> mouse_motion_signal;
     static entt::sigh<void(SDL_Keycode)> key_up_signal;
     static entt::sigh<void(SDL_Keycode)> key_down_signal;
+
+    static entt::sigh<void(std::span<const SDL_Event>)> event_batch_signal;
+    static entt::sigh<void(std::span<const SDL_MouseMotionEvent>)> mouse_moved_batch_signal;
+    static entt::sigh<void(std::span<const SDL_MouseButtonEvent>)> mouse_button_batch_signal;
+    static entt::sigh<void(std::span<const SDL_MouseWheelEvent>)> mouse_scroll_batch_signal;
+    static entt::sigh<void(std::span<const SDL_KeyboardEvent>)> key_batch_signal;
+    static entt::sigh<void()> polled_signal;
 };
 }
@@ -2,10 +2,12 @@
 
 #include <memory>
 #include <cstdint>
+#include <string_view>
 
 struct SDL_Window;
 struct SDL_Renderer;
 struct SDL_Surface;
+struct SDL_Texture;
 
 namespace ion
 {
@@ -27,6 +29,7 @@ struct sdl_deleter
     void operator()(SDL_Window * window) const;
     void operator()(SDL_Renderer * renderer) const;
     void operator()(SDL_Surface * surface) const;
+    void operator()(SDL_Texture * texture) const;
 };
 }
 
@@ -34,9 +37,11 @@ using sdl_system = std::unique_ptr<internal::sdl_system, internal::sdl_deleter>;
 using sdl_window = std::unique_ptr<SDL_Window, internal::sdl_deleter>;
 using sdl_renderer = std::unique_ptr<SDL_Renderer, internal::sdl_deleter>;
 using sdl_surface = std::unique_ptr<SDL_Surface, internal::sdl_deleter>;
+using sdl_texture = std::unique_ptr<SDL_Texture, internal::sdl_deleter>;
 
 sdl_system init_sdl(std::uint32_t init_flags);
 sdl_window create_window(std::string_view name, int width, int height, std::uint32_t window_flags);
 sdl_renderer create_renderer(SDL_Window * window);
 sdl_surface load_bitmap(std::string_view path);
+sdl_texture create_texture(SDL_Renderer * renderer, SDL_Surface * surface);
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL_mouse.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_scancode.h>
+
+namespace ion
+{
+/**
+ * Records and replays play sessions, so that a run can be repeated exactly
+ *
+ * A recording is a compact binary log of the random seeds a program asks for, the input that
+ * was held when it started reading input, and the frame time and events that each frame
+ * consumed. Replaying a log feeds those events back through the sdl_events signals and hands
+ * back the recorded frame times as a virtual clock, ignoring live input except for quit. When
+ * the log runs out, a quit event is published.
+ *
+ * Seeds and held input that are asked for while a frame's events are being published are
+ * recorded after that frame, so that they're replayed in the order they were asked for.
+ */
+class session
+{
+public:
+    /** The keys and mouse buttons that are held down, and where the mouse is */
+    struct held_input
+    {
+        std::vector<SDL_Scancode> keys;
+        SDL_MouseButtonFlags buttons = 0;
+        SDL_FPoint mouse{ -1, -1 };
+    };
+
+    /**
+     * Start recording a session
+     * \param path where to write the recording
+     * \return false if the recording couldn't be started
+     */
+    static bool record(std::string_view path);
+
+    /**
+     * Start replaying a recorded session
+     * \param path where the recording is
+     * \return false if the recording couldn't be opened
+     */
+    static bool replay(std::string_view path);
+
+    /**
+     * Record or replay a session as asked for by the command line
+     *
+     * Understands "--record <path>" and "--replay <path>", and leaves the session live
+     * otherwise.
+     *
+     * \return false if a recording or replay was asked for but couldn't be started
+     */
+    static bool from_args(int argc, char * argv[]);
+
+    /** Stop recording or replaying the session */
+    static void stop();
+
+    static bool is_recording();
+    static bool is_replaying();
+
+    /** A seed for a random engine, which is recorded or replayed with the session */
+    static std::uint32_t seed();
+
+    /**
+     * The input that's held down right now, which is recorded or replayed with the session
+     *
+     * Input that's held down isn't an event, so a program that tracks input from events asks
+     * for this once when it starts, rather than reading sdl's state.
+     */
+    static held_input input();
+
+    /**
+     * Poll the events for the next frame
+     *
+     * When live or recording, this polls sdl_events. When replaying, this publishes the
+     * events the recorded frame consumed instead.
+     *
+     * \param measured_dt the time in seconds since the last frame
+     * \return the time in seconds to simulate this frame with
+     */
+    static float poll(float measured_dt);
+};
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+
+struct SDL_Surface;
+
+namespace ion
+{
+/**
+ * A software rasterizer that draws to a surface from several threads at once
+ *
+ * The target is split into square bins. Commands are recorded between begin and end, and
+ * each one is added to every bin it touches. end then hands the bins out to worker threads,
+ * and each bin runs its commands in the order they were recorded, clipped to the bin - so the
+ * result is the same as drawing every command in order on one thread, no matter how the bins
+ * are scheduled.
+ *
+ * Only fills and tint blits can be recorded, since sdl's own blitters keep per-surface state
+ * that isn't safe to share between threads.
+ */
+class soft_raster
+{
+public:
+    /**
+     * Create a rasterizer
+     * \param num_workers the number of threads to rasterize with besides the one calling end
+     * \param bin_size the width and height of each bin in pixels
+     */
+    explicit soft_raster(std::size_t num_workers = default_num_workers(), int bin_size = 64);
+    ~soft_raster();
+
+    soft_raster(const soft_raster &) = delete;
+    soft_raster & operator=(const soft_raster &) = delete;
+
+    /**
+     * Start recording commands for a surface
+     *
+     * Anything recorded since the last end is discarded.
+     *
+     * \param target the surface to draw to
+     * \return false if the surface isn't 32-bit, or has to be locked to be drawn to
+     */
+    bool begin(SDL_Surface * target);
+
+    /**
+     * Clip the commands recorded after this
+     * \param rect the rect to clip to, or nullptr to clip to the whole target
+     */
+    void clip(const SDL_Rect * rect);
+
+    /** Record filling a rect with an opaque color */
+    void fill(const SDL_Rect & rect, const SDL_Color & color);
+
+    /**
+     * Record a tint blit of a surface to the target
+     *
+     * The source has to stay alive and unchanged until end returns.
+     *
+     * \param source the surface to composite, which has to be the size of the rect
+     * \param rect where to draw on the target
+     * \param fill the opaque color to fill the rect with
+     * \param modulate the color and alpha to multiply the source by
+     * \return false if the source can't be tint blitted to the target, in which case nothing
+     *         is recorded
+     */
+    bool tint_blit(SDL_Surface * source, const SDL_Rect & rect, const SDL_Color & fill,
+                   const SDL_Color & modulate = { 0xff, 0xff, 0xff, 0xff });
+
+    /** Rasterize every recorded command, and wait for it to finish */
+    void end();
+
+    /** Discard every recorded command without drawing them */
+    void discard();
+
+    /** The number of commands recorded since begin */
+    std::size_t size() const { return commands.size(); }
+
+    /** The number of threads rasterizing besides the one calling end */
+    std::size_t num_workers() const { return workers.size(); }
+
+    static std::size_t default_num_workers();
+private:
+    enum class command_kind : std::uint8_t { fill, tint_blit };
+    struct command
+    {
+        command_kind kind;
+        SDL_Rect rect;
+        SDL_Rect clip;
+        std::uint32_t mapped_fill;
+        SDL_Color fill;
+        SDL_Color modulate;
+        SDL_Surface * source;
+    };
+    void record(const command & cmd);
+    void rasterize_bins();
+    void rasterize(std::size_t bin) const;
+    void run_frames(std::stop_token stop);
+
+    SDL_Surface * target = nullptr;
+    const SDL_PixelFormatDetails * target_format = nullptr;
+    SDL_Rect clip_rect{ 0, 0, 0, 0 };
+    int bin_size;
+    int bins_wide = 0;
+    int bins_high = 0;
+
+    std::vector<command> commands;
+    // the indices of the commands that touch each bin, in the order they were recorded
+    std::vector<std::vector<std::uint32_t>> bin_commands;
+    std::vector<std::size_t> active_bins;
+
+    std::mutex frame_mutex;
+    std::condition_variable_any frame_started;
+    std::condition_variable frame_finished;
+    std::uint64_t frame = 0;
+    std::size_t num_busy = 0;
+    std::atomic<std::size_t> next_bin = 0;
+    std::vector<std::jthread> workers;
+};
+}
\ No newline at end of file
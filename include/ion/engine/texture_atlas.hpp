@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_rect.h>
+
+#include "ion/engine/sdl_resources.hpp"
+
+namespace ion
+{
+/**
+ * A single texture that many images have been packed into
+ *
+ * Each image is looked up by the id it was added with, and maps to a rect of normalized
+ * texture coordinates. The atlas also holds a block of white texels, so untextured fills can
+ * be drawn with the same texture as the images.
+ */
+class texture_atlas
+{
+public:
+    texture_atlas() = default;
+
+    SDL_Texture * texture() const { return atlas_texture.get(); }
+    int width() const { return atlas_width; }
+    int height() const { return atlas_height; }
+
+    /** The texture coordinates of an image, or nullptr if it isn't in the atlas */
+    const SDL_FRect * uv_for(std::uint32_t id) const;
+
+    /** Texture coordinates that sample only white texels */
+    const SDL_FRect & white_uv() const { return white; }
+
+    std::size_t size() const { return uvs.size(); }
+    explicit operator bool() const { return atlas_texture != nullptr; }
+private:
+    friend class atlas_builder;
+
+    sdl_texture atlas_texture;
+    int atlas_width = 0;
+    int atlas_height = 0;
+    std::unordered_map<std::uint32_t, SDL_FRect> uvs;
+    SDL_FRect white{ 0.f, 0.f, 0.f, 0.f };
+};
+
+/**
+ * Packs surfaces into a texture atlas
+ *
+ * Images are packed with a skyline bottom-left packer, tallest first, into the smallest
+ * power-of-two square that fits them all.
+ */
+class atlas_builder
+{
+public:
+    /**
+     * \param max_size the largest width and height the atlas may have
+     * \param padding the number of transparent texels to leave around each image
+     */
+    explicit atlas_builder(int max_size = 4096, int padding = 1);
+
+    /**
+     * Add an image to pack - the surface has to live until the atlas is built
+     * \param id the id to look the image up by
+     * \param surface the image to pack
+     */
+    void add(std::uint32_t id, SDL_Surface * surface);
+
+    /**
+     * Pack every image that was added and upload the atlas
+     * \return the atlas, which is empty if the images couldn't be packed or uploaded
+     */
+    texture_atlas build(SDL_Renderer * renderer) const;
+private:
+    int max_size;
+    int padding;
+    std::vector<std::pair<std::uint32_t, SDL_Surface *>> images;
+};
+}
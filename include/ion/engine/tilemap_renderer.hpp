@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_render.h>
+
+#include "ion/engine/texture_atlas.hpp"
+
+namespace ion
+{
+/**
+ * Batches tiles from a texture atlas into layers, and draws each layer with one call
+ *
+ * Tiles and fills are queued into layers each frame, and render draws the layers in order
+ * with a single SDL_RenderGeometry call each. Fills sample the atlas' white texels, so they
+ * draw in the same call as the tiles of their layer, tinted by their vertex colors. The
+ * vertex buffers are kept between frames, so a steady frame doesn't allocate.
+ */
+class tilemap_renderer
+{
+public:
+    explicit tilemap_renderer(std::size_t num_layers = 1);
+
+    /** Set the atlas to draw tiles from - tiles are skipped while there isn't one */
+    void atlas(const texture_atlas * atlas) { tile_atlas = atlas; }
+    const texture_atlas * atlas() const { return tile_atlas; }
+
+    /** Remove every queued tile and fill, keeping the memory for the next frame */
+    void clear();
+
+    /** Queue a solid rect */
+    void fill(std::size_t layer, const SDL_FRect & dst, const SDL_Color & color);
+
+    /**
+     * Queue a tile from the atlas
+     * \param layer the layer to draw the tile in
+     * \param tile the id the tile was added to the atlas with
+     * \param dst where to draw the tile
+     * \param tint the color to modulate the tile with
+     */
+    void draw(std::size_t layer, std::uint32_t tile, const SDL_FRect & dst,
+              const SDL_Color & tint = { 0xff, 0xff, 0xff, 0xff });
+
+    /** Draw every layer in order, with one call per layer that has anything in it */
+    void render(SDL_Renderer * renderer) const;
+
+    std::size_t num_layers() const { return layers.size(); }
+private:
+    struct layer_geometry
+    {
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+    const texture_atlas * tile_atlas = nullptr;
+    std::vector<layer_geometry> layers;
+};
+}
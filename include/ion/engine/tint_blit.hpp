@@ -0,0 +1,63 @@
+#pragma once
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+
+struct SDL_Surface;
+
+namespace ion
+{
+/** The implementations of tint_blit */
+enum class tint_blit_kernel
+{
+    automatic,  // the fastest kernel the cpu supports
+    scalar,
+    sse2,
+    avx2
+};
+
+/**
+ * Choose which kernel tint_blit uses
+ * \return false if the cpu doesn't support the kernel, in which case the choice is unchanged
+ */
+bool use_tint_blit_kernel(tint_blit_kernel kernel);
+
+/** The kernel tint_blit is using */
+tint_blit_kernel current_tint_blit_kernel();
+
+/**
+ * Fill a rect with a color and composite a surface over it, in a single pass
+ *
+ * The result matches filling the rect and then blending the surface onto it, with the
+ * surface's color key respected and its color and alpha modulated, using the same 8-bit
+ * arithmetic as sdl's blitters. The destination keeps the fill's value in its unused bits.
+ *
+ * Both surfaces have to be 32-bit with the same color channel layout, and the source may
+ * keep alpha in the bits the destination doesn't use - which is how blit_cache prepares them.
+ * The source has to be the size of the rect, and the blit is clipped to the destination's
+ * clip rect.
+ *
+ * \param source the surface to composite
+ * \param destination the surface to draw to
+ * \param rect where to draw on the destination
+ * \param fill the opaque color to fill the rect with
+ * \param modulate the color and alpha to multiply the source by
+ * \return false if the surfaces can't be blitted this way
+ */
+bool tint_blit(SDL_Surface * source, SDL_Surface * destination, const SDL_Rect & rect,
+               const SDL_Color & fill, const SDL_Color & modulate = { 0xff, 0xff, 0xff, 0xff });
+
+/**
+ * Fill and composite like tint_blit, clipped to a rect instead of the destination's clip rect
+ *
+ * This only reads the surfaces' formats and color keys and writes pixels inside the clip, so
+ * several threads can blit to disjoint parts of one destination at once.
+ *
+ * \param clip the rect to clip the blit to, which has to lie within the destination
+ */
+bool tint_blit(SDL_Surface * source, SDL_Surface * destination, const SDL_Rect & rect,
+               const SDL_Rect & clip, const SDL_Color & fill,
+               const SDL_Color & modulate = { 0xff, 0xff, 0xff, 0xff });
+
+/** Determine if tint_blit can blit from one surface's format to another's */
+bool can_tint_blit(const SDL_Surface * source, const SDL_Surface * destination);
+}
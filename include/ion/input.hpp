@@ -1,3 +1,4 @@
 #pragma once
 
 #include "ion/input/axis.hpp"
+#include "ion/input/snapshot.hpp"
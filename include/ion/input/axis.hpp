@@ -4,7 +4,7 @@
 #else
 #include <SDL3/SDL_keycode.h>
 #include <SDL3/SDL_rect.h>
-#include <SDL3/SDL_mouse.h>
+#include <SDL3/SDL_scancode.h>
 #endif
 
 namespace ion::input {
@@ -22,6 +22,10 @@ public:
 
 /**
  * A 2d axis that sets the value when keys are pressed
+ *
+ * Keys are bound by keycode, but looked up by the scancode they're on when they're bound, in
+ * the input snapshot - so reading the axis doesn't call into sdl. Bind the keys again if the
+ * keyboard layout changes.
  */
 class keyboard_axis : public axis2d {
 public:
@@ -36,17 +40,22 @@ public:
      */
     keyboard_axis(SDL_Keycode right, SDL_Keycode left, SDL_Keycode up, SDL_Keycode down);
 
+    /**
+     * Bind the axis to different keys
+     *
+     * \param right to bind to the positive x-axis
+     * \param left to bind to the negative x-axis
+     * \param up to bind to the positive y-axis
+     * \param down to bind to the negative y-axis
+     */
+    void bind(SDL_Keycode right, SDL_Keycode left, SDL_Keycode up, SDL_Keycode down);
+
     float x() const override;
     float y() const override;
 private:
-    SDL_Keycode _right, _left, _up, _down;
+    SDL_Scancode _right, _left, _up, _down;
 };
 
-/** Get the position of the mouse */
-inline SDL_FPoint mouse_position()
-{
-    SDL_FPoint mouse{-1, -1};
-    SDL_GetMouseState(&mouse.x, &mouse.y);
-    return mouse;
-}
+/** Get the position of the mouse, as of the last poll */
+SDL_FPoint mouse_position();
 }
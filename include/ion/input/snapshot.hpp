@@ -0,0 +1,95 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <span>
+
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_mouse.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_scancode.h>
+
+namespace ion::input {
+
+/**
+ * The state of the keyboard and mouse for one frame
+ *
+ * While capturing, the snapshot is built from the key and mouse events that each sdl_events
+ * poll publishes, and it's committed at the end of the poll. So everything that reads input
+ * in a frame sees the same state, reading it is a bit test rather than a call into sdl, and
+ * a replayed session's input is replayed along with its events.
+ *
+ * Along with what's held, the snapshot keeps what was held the poll before, and which keys
+ * and buttons were pressed or released during the poll - even if both happened within it.
+ */
+class snapshot {
+public:
+    /**
+     * Start capturing a snapshot every poll, if it isn't being captured yet. The snapshot
+     * starts out with what session::input says is held, so replays start out the same way.
+     */
+    static void capture();
+
+    /** Stop capturing snapshots - the current snapshot stays as it was */
+    static void stop_capturing();
+    static bool is_capturing();
+
+    /** The snapshot committed at the end of the last poll */
+    static snapshot const & current();
+
+    /** Determine if a key is held down */
+    bool held(SDL_Scancode key) const { return is_valid(key) and keys[key]; }
+
+    /** Determine if a key was held down at the end of the poll before */
+    bool was_held(SDL_Scancode key) const { return is_valid(key) and previous_keys[key]; }
+
+    /** Determine if a key was pressed during the last poll, not counting key repeats */
+    bool pressed(SDL_Scancode key) const { return is_valid(key) and pressed_keys[key]; }
+
+    /** Determine if a key was released during the last poll */
+    bool released(SDL_Scancode key) const { return is_valid(key) and released_keys[key]; }
+
+    /** Where the mouse is in the window */
+    SDL_FPoint mouse_position() const { return mouse; }
+
+    /** How far the mouse moved during the last poll */
+    SDL_FPoint mouse_motion() const { return motion; }
+
+    /** How far the mouse wheel scrolled during the last poll */
+    float mouse_scroll() const { return scroll; }
+
+    /** Determine if a mouse button, like SDL_BUTTON_LEFT, is held down */
+    bool mouse_held(std::uint8_t button) const { return buttons & button_mask(button); }
+    bool mouse_was_held(std::uint8_t button) const { return previous_buttons & button_mask(button); }
+    bool mouse_pressed(std::uint8_t button) const { return pressed_buttons & button_mask(button); }
+    bool mouse_released(std::uint8_t button) const { return released_buttons & button_mask(button); }
+
+    /** The number of polls that were captured before this one */
+    std::uint64_t frame() const { return frame_number; }
+private:
+    using key_bits = std::bitset<SDL_SCANCODE_COUNT>;
+
+    static bool is_valid(SDL_Scancode key) { return key > SDL_SCANCODE_UNKNOWN and key < SDL_SCANCODE_COUNT; }
+    static SDL_MouseButtonFlags button_mask(std::uint8_t button);
+
+    static void on_keys(std::span<const SDL_KeyboardEvent> events);
+    static void on_buttons(std::span<const SDL_MouseButtonEvent> events);
+    static void on_motion(std::span<const SDL_MouseMotionEvent> events);
+    static void on_scroll(std::span<const SDL_MouseWheelEvent> events);
+    static void on_polled();
+
+    key_bits keys;
+    key_bits previous_keys;
+    key_bits pressed_keys;
+    key_bits released_keys;
+
+    SDL_MouseButtonFlags buttons = 0;
+    SDL_MouseButtonFlags previous_buttons = 0;
+    SDL_MouseButtonFlags pressed_buttons = 0;
+    SDL_MouseButtonFlags released_buttons = 0;
+
+    SDL_FPoint mouse{-1, -1};
+    SDL_FPoint motion{0, 0};
+    float scroll = 0.f;
+    std::uint64_t frame_number = 0;
+};
+}
@@ -4,4 +4,5 @@
 #include "ion/serialization/misc_serialization.hpp"
 #include "ion/serialization/sdl_yaml.hpp"
 #include "ion/serialization/meta_yaml.hpp"
-#include "ion/serialization/color_yaml.hpp"
\ No newline at end of file
+#include "ion/serialization/color_yaml.hpp"
+#include "ion/serialization/flyweight_yaml.hpp"
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/meta/meta.hpp>
+#include <entt/meta/resolve.hpp>
+#include <yaml-cpp/node/node.h>
+
+#include "ion/mylar/reflect.hpp"
+
+namespace ion
+{
+/**
+ * A decode table that shares one immutable object between a yaml anchor and its aliases
+ *
+ * yaml-cpp resolves an alias to the same node as its anchor, so the table is keyed by node
+ * identity. Scanning a document finds the nodes that are reached more than once, and only
+ * those are kept: the first decode of one stores the result, and every alias of it hands back
+ * the stored object instead of decoding it again. Every other node is decoded as it's reached,
+ * and so are nodes that were built in code rather than parsed, since they have no position in
+ * a source to find them by.
+ *
+ * The table can also be passed to meta_decode, so aliases nested in reflected structs are
+ * only decoded once. Members hold values, so each of them gets a copy of the stored object.
+ * Objects live as long as the table or any handle to them, whichever is longer.
+ */
+class yaml_flyweights
+{
+public:
+    yaml_flyweights() = default;
+
+    /** Make a table for a document, which is scanned for shared nodes */
+    explicit yaml_flyweights(const YAML::Node & document);
+
+    /**
+     * Find the nodes of a document that are reached more than once, through an anchor and
+     * its aliases, so that they're kept once they're decoded
+     *
+     * \param document the root of the document to scan
+     */
+    void scan(const YAML::Node & document);
+
+    /** Determine if a node is reached more than once in a document that was scanned */
+    bool is_shared(const YAML::Node & node) const;
+
+    /**
+     * Decode a node into a shared object of a reflected type, which is interned if the node
+     * is shared
+     *
+     * \param node the node to decode
+     * \param type the reflected type to decode the node as
+     * \return the interned object, or nullptr if the node couldn't be decoded
+     */
+    std::shared_ptr<const entt::meta_any> decode(const YAML::Node & node, const entt::meta_type & type);
+
+    /**
+     * Decode a node into a shared, immutable value
+     *
+     * \param node the node to decode
+     * \return the shared value, or nullptr if the node couldn't be decoded
+     */
+    template<reflectable T>
+    requires std::default_initializable<T>
+    std::shared_ptr<const T> decode(const YAML::Node & node);
+
+    /** The number of distinct objects that have been interned */
+    std::size_t size() const { return num_objects; }
+
+    /** Forget every interned object - handles that are still held stay valid */
+    void clear();
+private:
+    struct entry
+    {
+        YAML::Node node;
+        entt::meta_type type;
+        std::shared_ptr<const entt::meta_any> object;
+    };
+    const entry * find(const YAML::Node & node, const entt::meta_type & type) const;
+
+    // buckets are keyed by the position of the node in its source, and nodes that share a
+    // position (like a block map and its first key) are told apart by identity and type -
+    // nodes without a position are never kept, so they can't all pile into one bucket
+    std::unordered_map<int, std::vector<YAML::Node>> shared_nodes;
+    std::unordered_map<int, std::vector<entry>> entries;
+    std::size_t num_objects = 0;
+};
+}
+
+template<ion::reflectable T>
+requires std::default_initializable<T>
+std::shared_ptr<const T> ion::yaml_flyweights::decode(const YAML::Node & node)
+{
+    reflect<T>();
+    auto object = decode(node, entt::resolve<T>());
+    if (not object) { return nullptr; }
+
+    // share ownership with the interned object rather than copying out of it
+    return std::shared_ptr<const T>{ object, object->template try_cast<const T>() };
+}
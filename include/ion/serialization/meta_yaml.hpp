@@ -7,6 +7,8 @@
 
 namespace ion
 {
+class yaml_flyweights;
+
 template<typename T>
 concept yaml_decodable =
     std::default_initializable<T> and
@@ -34,7 +36,18 @@ bool decode_unsigned_integer(const YAML::Node & number, entt::meta_any & obj);
 bool decode_with_function(const YAML::Node & node, const entt::meta_func & decode_fn, entt::meta_any & obj);
 bool decode_class(const YAML::Node & node, entt::meta_any & obj);
 bool decode_scalar(const YAML::Node & node, entt::meta_any & obj);
-bool decode_map(const YAML::Node & node, entt::meta_any & obj);
+
+/**
+ * Decode a node into a reflected object
+ *
+ * \param node the node to decode
+ * \param obj the object to decode into
+ * \param flyweights a table that aliased nodes are decoded once with, or nullptr to decode
+ *     every node as it's reached
+ * \return whether the node could be decoded
+ */
+bool decode_node(const YAML::Node & node, entt::meta_any & obj, yaml_flyweights * flyweights = nullptr);
+bool decode_map(const YAML::Node & node, entt::meta_any & obj, yaml_flyweights * flyweights = nullptr);
 }
 
 template<>
@@ -47,13 +60,11 @@ struct YAML::convert<entt::meta_any>
 namespace ion
 {
 template<reflectable T>
-bool meta_decode(const YAML::Node & node, T & val)
+bool meta_decode(const YAML::Node & node, T & val, yaml_flyweights * flyweights = nullptr)
 {
-    using as_any = YAML::convert<entt::meta_any>;
-
     reflect<T>();
     if (entt::meta_any any_val{ std::in_place_type<T &>, val };
-        as_any::decode(node, any_val))
+        decode_node(node, any_val, flyweights))
     {
         val = any_val.cast<T>();
         return true;
@@ -63,10 +74,10 @@ bool meta_decode(const YAML::Node & node, T & val)
 
 template<reflectable T>
 requires std::default_initializable<T>
-T read_yaml(const YAML::Node & node)
+T read_yaml(const YAML::Node & node, yaml_flyweights * flyweights = nullptr)
 {
     T val;
-    meta_decode(node, val);
+    meta_decode(node, val, flyweights);
     return val;
 }
 }
@@ -91,9 +102,5 @@ inline YAML::Node YAML::convert<entt::meta_any>::encode(const entt::meta_any & o
 
 inline bool YAML::convert<entt::meta_any>::decode(const Node & node, entt::meta_any & obj)
 {
-    if (not node) { return false; }
-    if (node.IsScalar()) { return ion::decode_scalar(node, obj); }
-    if (node.IsMap()) { return ion::decode_map(node, obj); }
-    std::printf("Failed to decode because type is neither scalar nor map (currently unsupported\n");
-    return false;
+    return ion::decode_node(node, obj);
 }
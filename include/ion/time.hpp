@@ -1,2 +1,8 @@
 # pragma once
 #include "ion/time/clock.hpp"
+#include "ion/time/fixed_step.hpp"
+#include "ion/time/frame_stats.hpp"
+#include "ion/time/histogram.hpp"
+#include "ion/time/telemetry.hpp"
+#include "ion/time/time_source.hpp"
+#include "ion/time/timer_wheel.hpp"
@@ -2,16 +2,27 @@
 
 #include <cstdint>
 #include <concepts>
-#include <SDL3/SDL_timer.h>
+#include "ion/time/frame_stats.hpp"
+#include "ion/time/histogram.hpp"
+#include "ion/time/time_source.hpp"
 
 namespace ion {
 
-/** A simple time interface */
+/**
+ * A simple time interface
+ *
+ * Time is measured in nanoseconds from a time source and converted to seconds as doubles, so
+ * deltas stay precise even at high frame rates. Every tick is also recorded in a rolling window of frame times,
+ * and can be counted in a histogram to keep the long tail of a whole session.
+ */
 class clock {
 public:
-    /** Initialize a clock */
-    clock()
-        : start_time{SDL_GetTicks()},  prev_time{start_time}
+    /**
+     * Initialize a clock
+     * \param source where the time comes from, which has to outlive the clock
+     */
+    explicit clock(time_source & source = time_source::current())
+        : source{&source}, start_time{source.now_ns()},  prev_time{start_time}
     {}
 
     /**
@@ -24,30 +35,48 @@ public:
     /** The time in seconds since the clock was initialized */
     template<std::floating_point real_t = float>
     real_t time() const;
+
+    /** The times between the most recent ticks */
+    frame_stats<> const & frames() const { return frame_times; }
+
+    /**
+     * Count the time between every tick in a histogram
+     * \param times the histogram to count in, or null to stop counting
+     */
+    void record_into(histogram * times) { frame_histogram = times; }
 private:
+    static constexpr double seconds_per_ns = 1e-9;
+
+    time_source * source;
     std::uint64_t start_time;
     std::uint64_t prev_time;
+    frame_stats<> frame_times;
+    histogram * frame_histogram = nullptr;
 };
 
 template<std::floating_point real_t>
 real_t clock::tick()
 {
     // get the current time
-    uint32_t const current_time = SDL_GetTicks();
+    std::uint64_t const current_time = source->now_ns();
 
     // calculate the number of seconds since the last call
-    real_t const dt = static_cast<real_t>(current_time-prev_time)/1000.;
+    double const dt = static_cast<double>(current_time-prev_time)*seconds_per_ns;
+    frame_times.record(dt);
+    if (frame_histogram) {
+        frame_histogram->record(current_time-prev_time);
+    }
 
     // update the clock
     prev_time = current_time;
-    return dt;
+    return static_cast<real_t>(dt);
 }
 
 
 template<std::floating_point real_t>
 real_t clock::time() const
 {
-    return static_cast<real_t>(SDL_GetTicks()-start_time)/1000.;
+    return static_cast<real_t>(static_cast<double>(source->now_ns()-start_time)*seconds_per_ns);
 }
 
 }
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+
+namespace ion {
+
+/**
+ * Runs a simulation in fixed-size steps, however long each frame takes
+ *
+ * Real time is accumulated each frame, and every whole step's worth of it is run as a step
+ * of the same size, so the simulation behaves the same at any frame rate. What's left over
+ * is less than a step, and alpha says how far into the next step the frame is, so rendering
+ * can interpolate between the last two steps.
+ *
+ * When frames take longer than the steps they need, running every step would only make the
+ * next frame longer, so at most max_steps are run each frame and the rest of the time is
+ * dropped.
+ */
+class fixed_step_loop {
+public:
+    /**
+     * \param step_rate the number of steps a second
+     * \param max_steps the most steps to run in a frame
+     */
+    explicit fixed_step_loop(double step_rate = 60., std::uint32_t max_steps = 8)
+        : step_seconds{1./std::max(step_rate, 1e-3)}, step_limit{std::max<std::uint32_t>(max_steps, 1)}
+    {}
+
+    /**
+     * Add a frame's worth of time
+     * \param dt the time in seconds since the last frame
+     * \return the number of steps to run this frame
+     */
+    std::uint32_t advance(double dt);
+
+    /**
+     * Add a frame's worth of time and run its steps
+     * \param dt the time in seconds since the last frame
+     * \param step what to call for each step, with the step size in seconds
+     * \return the number of steps that were run
+     */
+    template<std::invocable<double> Step>
+    std::uint32_t run(double dt, Step && step);
+
+    /** The size of each step in seconds */
+    double step() const { return step_seconds; }
+
+    /** Set the number of steps a second, keeping how far into the next step the frame is */
+    void step_rate(double rate);
+    double step_rate() const { return 1./step_seconds; }
+
+    void max_steps(std::uint32_t steps) { step_limit = std::max<std::uint32_t>(steps, 1); }
+    std::uint32_t max_steps() const { return step_limit; }
+
+    /** How far the frame is between the last step and the next one, from 0 up to 1 */
+    template<std::floating_point real_t = float>
+    real_t alpha() const { return static_cast<real_t>(accumulated/step_seconds); }
+
+    /** The number of steps that have been run */
+    std::uint64_t num_steps() const { return total_steps; }
+
+    /** The time in seconds that was dropped to keep up */
+    double dropped_time() const { return total_dropped; }
+
+    /** Forget any accumulated time */
+    void reset() { accumulated = 0.; }
+private:
+    double step_seconds;
+    std::uint32_t step_limit;
+    double accumulated = 0.;
+    std::uint64_t total_steps = 0;
+    double total_dropped = 0.;
+};
+
+inline std::uint32_t fixed_step_loop::advance(double dt)
+{
+    accumulated += std::max(dt, 0.);
+    auto steps = static_cast<std::uint32_t>(std::min(accumulated/step_seconds,
+                                                     static_cast<double>(step_limit)));
+    accumulated -= steps*step_seconds;
+
+    // the simulation can't keep up, so drop whatever it won't get to
+    if (steps == step_limit and accumulated >= step_seconds) {
+        const double kept = std::fmod(accumulated, step_seconds);
+        total_dropped += accumulated - kept;
+        accumulated = kept;
+    }
+    total_steps += steps;
+    return steps;
+}
+
+template<std::invocable<double> Step>
+std::uint32_t fixed_step_loop::run(double dt, Step && step)
+{
+    const std::uint32_t steps = advance(dt);
+    for (std::uint32_t i = 0; i < steps; ++i) {
+        step(step_seconds);
+    }
+    return steps;
+}
+
+inline void fixed_step_loop::step_rate(double rate)
+{
+    const double progress = accumulated/step_seconds;
+    step_seconds = 1./std::max(rate, 1e-3);
+    accumulated = progress*step_seconds;
+}
+
+}
\ No newline at end of file
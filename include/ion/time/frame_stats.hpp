@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace ion {
+
+/** A summary of the frame times in a frame_stats window, all in seconds */
+struct frame_summary {
+    double min = 0.;
+    double max = 0.;
+    double mean = 0.;
+    double p50 = 0.;
+    double p95 = 0.;
+    double p99 = 0.;
+};
+
+/**
+ * A rolling window of the last few frame times
+ *
+ * The window is a fixed-size ring, so recording a frame time never allocates, and neither
+ * does summarizing it - percentiles are found in a scratch copy that's kept alongside the
+ * window. Summaries are meant to be taken now and then, like once a second for an overlay or
+ * at shutdown, rather than every frame.
+ *
+ * \tparam Capacity the number of frame times to keep
+ */
+template<std::size_t Capacity = 240>
+class frame_stats {
+    static_assert(Capacity > 0, "frame_stats needs room for at least one frame time");
+public:
+    /** Add a frame time in seconds, forgetting the oldest one if the window is full */
+    void record(double seconds);
+
+    /** Forget every frame time */
+    void clear() { next = 0; count = 0; }
+
+    /** The frame time recorded most recently, or 0 if there are none */
+    double latest() const { return count? frames[(next + Capacity - 1) % Capacity] : 0.; }
+
+    double min() const;
+    double max() const;
+    double mean() const;
+
+    /**
+     * The frame time that a fraction of the window is at or below
+     * \param fraction how far through the window from fastest to slowest, from 0 up to 1
+     * \return the nearest frame time in the window, or 0 if there are none
+     */
+    double percentile(double fraction) const;
+
+    /** The min, max, mean, and 50th, 95th and 99th percentiles of the window */
+    frame_summary summary() const;
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+private:
+    // sort the window into scratch and return how many frame times are in it
+    std::size_t sorted() const;
+    double rank(std::size_t n, double fraction) const;
+
+    std::array<double, Capacity> frames{};
+    mutable std::array<double, Capacity> scratch{};
+    std::size_t next = 0;
+    std::size_t count = 0;
+};
+
+template<std::size_t Capacity>
+void frame_stats<Capacity>::record(double seconds)
+{
+    frames[next] = seconds;
+    next = (next + 1) % Capacity;
+    count = std::min(count + 1, Capacity);
+}
+
+template<std::size_t Capacity>
+double frame_stats<Capacity>::min() const
+{
+    return count? *std::min_element(frames.begin(), frames.begin() + count) : 0.;
+}
+
+template<std::size_t Capacity>
+double frame_stats<Capacity>::max() const
+{
+    return count? *std::max_element(frames.begin(), frames.begin() + count) : 0.;
+}
+
+template<std::size_t Capacity>
+double frame_stats<Capacity>::mean() const
+{
+    if (count == 0) {
+        return 0.;
+    }
+    double sum = 0.;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += frames[i];
+    }
+    return sum/static_cast<double>(count);
+}
+
+template<std::size_t Capacity>
+double frame_stats<Capacity>::percentile(double fraction) const
+{
+    if (count == 0) {
+        return 0.;
+    }
+    // only the one rank is needed, so partition rather than sort
+    std::copy_n(frames.begin(), count, scratch.begin());
+    const auto nth = scratch.begin() + static_cast<std::ptrdiff_t>(
+        std::lround(std::clamp(fraction, 0., 1.)*static_cast<double>(count - 1)));
+    std::nth_element(scratch.begin(), nth, scratch.begin() + count);
+    return *nth;
+}
+
+template<std::size_t Capacity>
+frame_summary frame_stats<Capacity>::summary() const
+{
+    const std::size_t n = sorted();
+    if (n == 0) {
+        return {};
+    }
+    return frame_summary{
+        .min = scratch[0], .max = scratch[n - 1], .mean = mean(),
+        .p50 = rank(n, .5), .p95 = rank(n, .95), .p99 = rank(n, .99)
+    };
+}
+
+template<std::size_t Capacity>
+std::size_t frame_stats<Capacity>::sorted() const
+{
+    std::copy_n(frames.begin(), count, scratch.begin());
+    std::sort(scratch.begin(), scratch.begin() + count);
+    return count;
+}
+
+template<std::size_t Capacity>
+double frame_stats<Capacity>::rank(std::size_t n, double fraction) const
+{
+    return scratch[static_cast<std::size_t>(std::lround(fraction*static_cast<double>(n - 1)))];
+}
+
+}
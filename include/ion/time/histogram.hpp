@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ion {
+
+/**
+ * A histogram of durations in nanoseconds, with a fixed amount of memory
+ *
+ * Buckets are log-linear, like HdrHistogram's: values below 2^precision_bits each get their
+ * own bucket, and above that every power of two is split into 2^precision_bits buckets of
+ * equal width. So any value is known to within 1/2^precision_bits of itself - better than 1% -
+ * whether it's a microsecond or a minute, and hours of frame times fit in the same few dozen
+ * kilobytes as a handful. Values past max_value are counted in the last bucket, but the true
+ * maximum is still kept.
+ *
+ * Histograms aren't synchronized, so record from one thread at a time - threads can each
+ * have their own histogram and merge them afterwards.
+ */
+class histogram {
+public:
+    static constexpr std::uint32_t precision_bits = 7;
+    static constexpr std::uint32_t range_bits = 40;
+
+    /** The largest value that's kept precisely - a bit over 18 minutes */
+    static constexpr std::uint64_t max_value = (std::uint64_t{1} << range_bits) - 1;
+
+    /**
+     * Count a value
+     * \param value_ns the value in nanoseconds
+     * \param times the number of times to count it
+     */
+    void record(std::uint64_t value_ns, std::uint64_t times = 1);
+
+    /** Count a value given in seconds */
+    void record_seconds(double seconds);
+
+    /** Add all of the counts of another histogram to this one */
+    void merge(histogram const & other);
+
+    /** Forget every value */
+    void reset();
+
+    /** The number of values that were counted */
+    std::uint64_t count() const { return total_count; }
+    bool empty() const { return total_count == 0; }
+
+    std::uint64_t min() const { return total_count? min_ns : 0; }
+    std::uint64_t max() const { return max_ns; }
+
+    /** The mean of every value in nanoseconds, or 0 if there are none */
+    double mean() const;
+
+    /**
+     * The value that a fraction of the counted values are at or below
+     * \param fraction how far from the smallest to the largest value, from 0 up to 1 - so
+     *                 .999 is the 99.9th percentile
+     * \return the largest value in the bucket the percentile falls in, or 0 if there are none
+     */
+    std::uint64_t percentile(double fraction) const;
+
+    /**
+     * Visit the buckets that have values in them, from the smallest values up
+     * \param visit called with the smallest and largest values of the bucket, and its count
+     */
+    template<typename Visitor>
+    void for_each_bucket(Visitor && visit) const;
+private:
+    static constexpr std::size_t sub_buckets = std::size_t{1} << precision_bits;
+    static constexpr std::size_t num_buckets = (range_bits - precision_bits + 1)*sub_buckets;
+
+    static std::size_t index_of(std::uint64_t value);
+    static std::uint64_t lowest_in(std::size_t index);
+    static std::uint64_t highest_in(std::size_t index);
+
+    std::array<std::uint64_t, num_buckets> counts{};
+    std::uint64_t total_count = 0;
+    std::uint64_t min_ns = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ns = 0;
+    double sum_ns = 0.;
+};
+
+inline void histogram::record(std::uint64_t value_ns, std::uint64_t times)
+{
+    if (times == 0) {
+        return;
+    }
+    counts[index_of(value_ns)] += times;
+    total_count += times;
+    min_ns = std::min(min_ns, value_ns);
+    max_ns = std::max(max_ns, value_ns);
+    sum_ns += static_cast<double>(value_ns)*static_cast<double>(times);
+}
+
+inline void histogram::record_seconds(double seconds)
+{
+    record(static_cast<std::uint64_t>(std::max(seconds, 0.)*1e9 + .5));
+}
+
+inline void histogram::merge(histogram const & other)
+{
+    for (std::size_t i = 0; i < num_buckets; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total_count += other.total_count;
+    min_ns = std::min(min_ns, other.min_ns);
+    max_ns = std::max(max_ns, other.max_ns);
+    sum_ns += other.sum_ns;
+}
+
+inline void histogram::reset()
+{
+    counts.fill(0);
+    total_count = 0;
+    min_ns = std::numeric_limits<std::uint64_t>::max();
+    max_ns = 0;
+    sum_ns = 0.;
+}
+
+inline double histogram::mean() const
+{
+    return total_count? sum_ns/static_cast<double>(total_count) : 0.;
+}
+
+inline std::uint64_t histogram::percentile(double fraction) const
+{
+    if (total_count == 0) {
+        return 0;
+    }
+    // the rank of the value, counting from one, rounded up so that p100 is the largest value
+    const double clamped = std::clamp(fraction, 0., 1.);
+    const auto rank = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(clamped*static_cast<double>(total_count))), 1);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < num_buckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // values past the range all land in the last bucket, so only the maximum is known
+            return i + 1 == num_buckets? max_ns : std::clamp(highest_in(i), min_ns, max_ns);
+        }
+    }
+    return max_ns;
+}
+
+template<typename Visitor>
+void histogram::for_each_bucket(Visitor && visit) const
+{
+    for (std::size_t i = 0; i < num_buckets; ++i) {
+        if (counts[i] != 0) {
+            visit(lowest_in(i), highest_in(i), counts[i]);
+        }
+    }
+}
+
+inline std::size_t histogram::index_of(std::uint64_t value)
+{
+    value = std::min(value, max_value);
+    if (value < sub_buckets) {
+        return static_cast<std::size_t>(value);
+    }
+    // the power of two the value is in picks the group of buckets, and the bits just below
+    // its highest one pick the bucket in the group
+    const auto exponent = static_cast<std::uint32_t>(std::bit_width(value)) - 1;
+    const std::uint32_t shift = exponent - precision_bits;
+    return (shift + 1)*sub_buckets + static_cast<std::size_t>((value >> shift) - sub_buckets);
+}
+
+inline std::uint64_t histogram::lowest_in(std::size_t index)
+{
+    if (index < sub_buckets) {
+        return index;
+    }
+    const std::size_t group = index >> precision_bits;
+    const std::size_t sub_bucket = index & (sub_buckets - 1);
+    return static_cast<std::uint64_t>(sub_buckets + sub_bucket) << (group - 1);
+}
+
+inline std::uint64_t histogram::highest_in(std::size_t index)
+{
+    const std::size_t group = index >> precision_bits;
+    const std::uint64_t width = group == 0? 1 : std::uint64_t{1} << (group - 1);
+    return lowest_in(index) + width - 1;
+}
+
+}
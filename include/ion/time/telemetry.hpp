@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+
+#include "ion/time/histogram.hpp"
+
+namespace ion {
+
+/**
+ * Named histograms of how long things take, that can be exported for analysis
+ *
+ * Each scope is a histogram that's created the first time it's asked for, and lives until the
+ * program exits, so references to it can be kept - like a clock's frame times, or a
+ * scoped_timer around a system. Exports summarize each scope with its count, min, mean, max
+ * and 50th, 90th, 99th, 99.9th and 99.99th percentiles in nanoseconds, and json exports also
+ * list every bucket, so that exports from different runs can be merged.
+ *
+ * Looking up scopes is synchronized, but the histograms themselves aren't, so each scope
+ * should only be recorded to from one thread, and exported once recording has stopped.
+ */
+class telemetry {
+public:
+    enum class format {
+        csv,
+        json
+    };
+
+    /** The histogram for a named scope */
+    static histogram & scope(std::string_view name);
+
+    /** Forget the values of every scope */
+    static void reset();
+
+    /** Write every scope to a stream */
+    static void write(std::ostream & out, format as);
+
+    /**
+     * Write every scope to a file
+     * \return false if the file couldn't be opened
+     */
+    static bool export_to(std::string_view path, format as);
+
+    /** Write every scope to a file, as json if its extension is .json and csv otherwise */
+    static bool export_to(std::string_view path) { return export_to(path, format_of(path)); }
+
+    /**
+     * Write every scope to a file when the program exits
+     * \param path the file to write, or empty to cancel the export
+     */
+    static void export_at_exit(std::string_view path);
+
+    static format format_of(std::string_view path);
+private:
+    struct registry {
+        std::mutex mutex;
+        std::map<std::string, histogram, std::less<>> scopes;
+        std::string exit_path;
+
+        ~registry();
+    };
+    static registry & instance();
+
+    static bool export_scopes(std::string_view path, format as, registry & scopes);
+    static void write_scopes(std::ostream & out, format as, registry & scopes);
+    static void write_csv(std::ostream & out, registry & scopes);
+    static void write_json(std::ostream & out, registry & scopes);
+    static void write_string(std::ostream & out, std::string_view text, format as);
+};
+
+/** Times how long it is in scope, and records it to a histogram when it leaves */
+class scoped_timer {
+public:
+    explicit scoped_timer(histogram & times) : times{times}, start{SDL_GetTicksNS()} {}
+    explicit scoped_timer(std::string_view scope) : scoped_timer{telemetry::scope(scope)} {}
+
+    scoped_timer(scoped_timer const &) = delete;
+    scoped_timer & operator=(scoped_timer const &) = delete;
+
+    ~scoped_timer() { times.record(SDL_GetTicksNS() - start); }
+private:
+    histogram & times;
+    std::uint64_t start;
+};
+
+namespace internal {
+// the percentiles that are exported for every scope
+inline constexpr std::pair<std::string_view, double> exported_percentiles[]{
+    {"p50", .5}, {"p90", .9}, {"p99", .99}, {"p99.9", .999}, {"p99.99", .9999}
+};
+}
+
+inline telemetry::registry & telemetry::instance()
+{
+    static registry scopes;
+    return scopes;
+}
+
+inline telemetry::registry::~registry()
+{
+    // the registry is being destroyed, so it has to be written without looking it up again
+    if (not exit_path.empty()) {
+        std::scoped_lock lock{mutex};
+        export_scopes(exit_path, format_of(exit_path), *this);
+    }
+}
+
+inline histogram & telemetry::scope(std::string_view name)
+{
+    auto & scopes = instance();
+    std::scoped_lock lock{scopes.mutex};
+    if (auto const found = scopes.scopes.find(name); found != scopes.scopes.end()) {
+        return found->second;
+    }
+    return scopes.scopes.try_emplace(std::string{name}).first->second;
+}
+
+inline void telemetry::reset()
+{
+    auto & scopes = instance();
+    std::scoped_lock lock{scopes.mutex};
+    for (auto & [name, times] : scopes.scopes) {
+        times.reset();
+    }
+}
+
+inline void telemetry::write(std::ostream & out, format as)
+{
+    auto & scopes = instance();
+    std::scoped_lock lock{scopes.mutex};
+    write_scopes(out, as, scopes);
+}
+
+inline bool telemetry::export_to(std::string_view path, format as)
+{
+    auto & scopes = instance();
+    std::scoped_lock lock{scopes.mutex};
+    return export_scopes(path, as, scopes);
+}
+
+inline void telemetry::export_at_exit(std::string_view path)
+{
+    auto & scopes = instance();
+    std::scoped_lock lock{scopes.mutex};
+    scopes.exit_path = path;
+}
+
+inline telemetry::format telemetry::format_of(std::string_view path)
+{
+    return path.ends_with(".json")? format::json : format::csv;
+}
+
+inline bool telemetry::export_scopes(std::string_view path, format as, registry & scopes)
+{
+    std::ofstream out{std::string{path}, std::ios::trunc};
+    if (not out) {
+        SDL_Log("Couldn't export telemetry because %.*s couldn't be opened\n",
+                static_cast<int>(path.size()), path.data());
+        return false;
+    }
+    write_scopes(out, as, scopes);
+    return true;
+}
+
+inline void telemetry::write_scopes(std::ostream & out, format as, registry & scopes)
+{
+    if (as == format::json) {
+        write_json(out, scopes);
+    } else {
+        write_csv(out, scopes);
+    }
+}
+
+inline void telemetry::write_csv(std::ostream & out, registry & scopes)
+{
+    out << "scope,count,min_ns,mean_ns";
+    for (auto const & [name, fraction] : internal::exported_percentiles) {
+        out << ',' << name << "_ns";
+    }
+    out << ",max_ns\n";
+
+    out << std::fixed << std::setprecision(1);
+    for (auto const & [name, times] : scopes.scopes) {
+        write_string(out, name, format::csv);
+        out << ',' << times.count() << ',' << times.min() << ',' << times.mean();
+        for (auto const & [percentile, fraction] : internal::exported_percentiles) {
+            out << ',' << times.percentile(fraction);
+        }
+        out << ',' << times.max() << '\n';
+    }
+}
+
+inline void telemetry::write_json(std::ostream & out, registry & scopes)
+{
+    out << std::fixed << std::setprecision(1) << "{\"scopes\": [";
+    bool is_first = true;
+    for (auto const & [name, times] : scopes.scopes) {
+        out << (is_first? "\n  {" : ",\n  {") << "\"name\": ";
+        write_string(out, name, format::json);
+        out << ", \"count\": " << times.count() << ", \"min_ns\": " << times.min()
+            << ", \"mean_ns\": " << times.mean() << ", \"max_ns\": " << times.max();
+        for (auto const & [percentile, fraction] : internal::exported_percentiles) {
+            out << ", \"" << percentile << "_ns\": " << times.percentile(fraction);
+        }
+        // each bucket is its smallest value, largest value and count
+        out << ",\n   \"buckets\": [";
+        bool is_first_bucket = true;
+        times.for_each_bucket([&](std::uint64_t lowest, std::uint64_t highest, std::uint64_t count) {
+            out << (is_first_bucket? "" : ", ") << '[' << lowest << ", " << highest << ", " << count << ']';
+            is_first_bucket = false;
+        });
+        out << "]}";
+        is_first = false;
+    }
+    out << "\n]}\n";
+}
+
+inline void telemetry::write_string(std::ostream & out, std::string_view text, format as)
+{
+    // csv only needs quotes when there's a delimiter or quote in the way
+    if (as == format::csv and text.find_first_of(",\"\n") == std::string_view::npos) {
+        out << text;
+        return;
+    }
+    out << '"';
+    for (char const c : text) {
+        if (c == '"') {
+            out << (as == format::csv? "\"\"" : "\\\"");
+        } else if (as == format::json and c == '\\') {
+            out << "\\\\";
+        } else if (as == format::json and static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                << std::dec << std::setfill(' ');
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <SDL3/SDL_timer.h>
+
+namespace ion {
+
+/**
+ * Where the time comes from
+ *
+ * Clocks and paced loops read the time and sleep through the current time source, rather
+ * than asking sdl directly, so the time can be swapped out at runtime: real time for playing,
+ * virtual time that only moves when it's told to for deterministic or headless runs, or real
+ * time sped up or slowed down.
+ *
+ * Sources have to outlive their use as the current source.
+ */
+class time_source {
+public:
+    virtual ~time_source() = default;
+
+    /** The time in nanoseconds since some fixed point */
+    virtual std::uint64_t now_ns() const = 0;
+
+    /** Wait until some time in nanoseconds has passed */
+    virtual void sleep_ns(std::uint64_t ns) = 0;
+
+    /** The source clocks and loops use, which is real time unless another one was chosen */
+    static time_source & current() { return *current_slot().load(std::memory_order_acquire); }
+
+    /**
+     * Choose the source that clocks and loops use from now on - clocks that already exist
+     * keep the source they were made with
+     * \param source the source to use, or null to go back to real time
+     */
+    static void use(time_source * source);
+
+    /** The real time source */
+    static time_source & real();
+private:
+    static std::atomic<time_source *> & current_slot();
+};
+
+/** Real time, as sdl measures it */
+class real_time : public time_source {
+public:
+    std::uint64_t now_ns() const override { return SDL_GetTicksNS(); }
+    void sleep_ns(std::uint64_t ns) override { SDL_DelayPrecise(ns); }
+};
+
+/**
+ * Time that only moves when it's advanced
+ *
+ * Sleeping advances the time right away instead of waiting, so a loop that's paced by sleeping
+ * runs as fast as it can, while the time it sees goes up by exactly one frame each iteration.
+ */
+class virtual_time : public time_source {
+public:
+    explicit virtual_time(std::uint64_t start_ns = 0) : time{start_ns} {}
+
+    std::uint64_t now_ns() const override { return time.load(std::memory_order_acquire); }
+    void sleep_ns(std::uint64_t ns) override { advance_ns(ns); }
+
+    void advance_ns(std::uint64_t ns) { time.fetch_add(ns, std::memory_order_acq_rel); }
+    void advance(double seconds) { advance_ns(static_cast<std::uint64_t>(std::max(seconds, 0.)*1e9 + .5)); }
+    void set_ns(std::uint64_t ns) { time.store(ns, std::memory_order_release); }
+private:
+    std::atomic<std::uint64_t> time;
+};
+
+/**
+ * Another source's time, sped up or slowed down
+ *
+ * Changing the scale only changes how fast time moves from then on, so the time never jumps.
+ * The scale should only be changed from one thread.
+ */
+class scaled_time : public time_source {
+public:
+    /**
+     * \param base the source to scale
+     * \param scale how many times faster than the base time moves
+     */
+    explicit scaled_time(time_source & base, double scale = 1.)
+        : base{base}, base_origin{base.now_ns()}, origin{base_origin}, time_scale{clamped(scale)}
+    {}
+
+    std::uint64_t now_ns() const override;
+    void sleep_ns(std::uint64_t ns) override;
+
+    void scale(double scale);
+    double scale() const { return time_scale; }
+private:
+    static double clamped(double scale) { return std::max(scale, 1e-6); }
+
+    time_source & base;
+    std::uint64_t base_origin;
+    std::uint64_t origin;
+    double time_scale;
+};
+
+inline time_source & time_source::real()
+{
+    static real_time source;
+    return source;
+}
+
+inline std::atomic<time_source *> & time_source::current_slot()
+{
+    // a function static, so that the source can be used while other statics are initialized
+    static std::atomic<time_source *> slot{&real()};
+    return slot;
+}
+
+inline void time_source::use(time_source * source)
+{
+    current_slot().store(source? source : &real(), std::memory_order_release);
+}
+
+inline std::uint64_t scaled_time::now_ns() const
+{
+    const auto elapsed = static_cast<double>(base.now_ns() - base_origin);
+    return origin + static_cast<std::uint64_t>(elapsed*time_scale);
+}
+
+inline void scaled_time::sleep_ns(std::uint64_t ns)
+{
+    base.sleep_ns(static_cast<std::uint64_t>(static_cast<double>(ns)/time_scale));
+}
+
+inline void scaled_time::scale(double scale)
+{
+    // start measuring again from now, so that only time from now on is scaled differently
+    origin = now_ns();
+    base_origin = base.now_ns();
+    time_scale = clamped(scale);
+}
+
+}
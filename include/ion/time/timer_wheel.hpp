@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ion {
+
+/** Identifies a timer in a timer_wheel, and stops being valid once the timer is done */
+struct timer_id {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    friend bool operator==(timer_id, timer_id) = default;
+};
+
+/**
+ * Schedules a large number of timers, without checking each of them every frame
+ *
+ * Time is counted in ticks, and timers are kept in four wheels of 256 slots each: the first
+ * has a slot for each of the next 256 ticks, the second a slot for each of the 256 ticks
+ * after that, and so on - so timers up to 2^32 ticks away are each in exactly one slot. Each
+ * tick only the slot for that tick is looked at, and every 256 ticks the next slot of the
+ * wheel above is spread out into the one below. Scheduling and cancelling are both constant
+ * time, and advancing only touches the timers that are due, no matter how many are waiting.
+ *
+ * Advance the wheel with the time that's passed - like what ion::clock::tick returns - and
+ * either call a function for each timer that's due, or collect them into a ready list. Timers
+ * due in the same tick are fired in no particular order.
+ *
+ * \tparam Payload what each timer carries, like a callback or an entity
+ */
+template<typename Payload>
+class timer_wheel {
+public:
+    /** \param tick_seconds the resolution of the timers in seconds */
+    explicit timer_wheel(double tick_seconds = .001)
+        : tick_seconds{std::max(tick_seconds, 1e-9)}
+    {}
+
+    /**
+     * Schedule a timer
+     * \param delay the seconds from now until the timer is due - it's due no sooner than the
+     *              next tick
+     * \param payload what the timer carries
+     * \param period the seconds between each time the timer is due after that, or 0 to only
+     *               be due once
+     * \return the id to cancel the timer with
+     */
+    timer_id schedule(double delay, Payload payload, double period = 0.);
+
+    /**
+     * Stop a timer from being due - may be called while the wheel is firing
+     * \return false if the timer was already done or cancelled
+     */
+    bool cancel(timer_id id);
+
+    /** Determine if a timer is still waiting to be due */
+    bool is_scheduled(timer_id id) const;
+
+    /**
+     * Move time forward, firing each timer that's due
+     * \param seconds the time that's passed
+     * \param fire called with the payload of each timer that's due, and may schedule or cancel
+     *             timers
+     * \return the number of timers that were fired
+     */
+    template<std::invocable<Payload &> Fire>
+    std::size_t advance(double seconds, Fire && fire);
+
+    /**
+     * Move time forward, collecting the payload of each timer that's due
+     * \param seconds the time that's passed
+     * \param ready where the payloads are added to
+     * \return the number of timers that were due
+     */
+    std::size_t advance(double seconds, std::vector<Payload> & ready);
+
+    /** Move time forward, calling the payload of each timer that's due */
+    std::size_t advance(double seconds) requires std::invocable<Payload &>;
+
+    /** Cancel every timer */
+    void clear();
+
+    /** The number of timers that are scheduled */
+    std::size_t size() const { return num_scheduled; }
+    bool empty() const { return num_scheduled == 0; }
+
+    /** The time in seconds the wheel has been advanced */
+    double now() const { return static_cast<double>(current_tick)*tick_seconds; }
+    double resolution() const { return tick_seconds; }
+private:
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t slot_bits = 8;
+    static constexpr std::uint32_t num_slots = 1u << slot_bits;
+    static constexpr std::uint32_t num_levels = 4;
+    static constexpr std::uint64_t max_delay = (std::uint64_t{1} << (slot_bits*num_levels)) - 1;
+
+    struct timer {
+        Payload payload{};
+        std::uint64_t deadline = 0;
+        std::uint64_t period = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t prev = none;
+        std::uint32_t next = none;
+
+        // which list the timer is in - a slot of one of the wheels, the due list, or none -
+        // kept as indices rather than a pointer so the wheel can be copied and moved
+        std::uint32_t level = no_list;
+        std::uint32_t slot = 0;
+        bool is_cancelled = false;
+    };
+
+    static constexpr std::uint32_t no_list = num_levels;
+    static constexpr std::uint32_t due_list = num_levels + 1;
+
+    std::uint64_t to_ticks(double seconds) const;
+
+    // put a timer in the slot for its deadline, relative to the current tick
+    void place(std::uint32_t index);
+    std::uint32_t & head_of(timer const & linked);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+
+    // take every timer out of a slot, and return the first of them
+    std::uint32_t take(std::uint32_t & head);
+
+    template<typename Fire>
+    std::size_t fire_tick(Fire & fire);
+
+    double tick_seconds;
+    double pending_ticks = 0.;
+    std::uint64_t current_tick = 0;
+
+    // timers are kept in a deque so that payloads stay put while they're being fired, even
+    // if firing schedules more timers
+    std::deque<timer> timers;
+    std::vector<std::uint32_t> free_timers;
+    std::array<std::array<std::uint32_t, num_slots>, num_levels> slots = make_empty_slots();
+    std::array<std::size_t, num_levels> level_sizes{};
+    std::size_t num_scheduled = 0;
+    std::uint32_t due = none;
+    std::uint32_t firing = none;
+
+    static constexpr auto make_empty_slots()
+    {
+        std::array<std::array<std::uint32_t, num_slots>, num_levels> empty{};
+        for (auto & level : empty) {
+            level.fill(none);
+        }
+        return empty;
+    }
+};
+
+template<typename Payload>
+timer_id timer_wheel<Payload>::schedule(double delay, Payload payload, double period)
+{
+    std::uint32_t index;
+    if (free_timers.empty()) {
+        index = static_cast<std::uint32_t>(timers.size());
+        timers.emplace_back();
+    } else {
+        index = free_timers.back();
+        free_timers.pop_back();
+    }
+    timer & scheduled = timers[index];
+    scheduled.payload = std::move(payload);
+    scheduled.deadline = current_tick + std::max<std::uint64_t>(to_ticks(delay), 1);
+    scheduled.period = period > 0.? std::max<std::uint64_t>(to_ticks(period), 1) : 0;
+    scheduled.is_cancelled = false;
+    place(index);
+    ++num_scheduled;
+    return timer_id{index, scheduled.generation};
+}
+
+template<typename Payload>
+bool timer_wheel<Payload>::cancel(timer_id id)
+{
+    if (not is_scheduled(id)) {
+        return false;
+    }
+    // the timer being fired is released once its payload is done with
+    if (id.index == firing) {
+        timers[id.index].is_cancelled = true;
+        --num_scheduled;
+        return true;
+    }
+    unlink(id.index);
+    release(id.index);
+    --num_scheduled;
+    return true;
+}
+
+template<typename Payload>
+bool timer_wheel<Payload>::is_scheduled(timer_id id) const
+{
+    return id.index < timers.size() and timers[id.index].generation == id.generation
+                                    and not timers[id.index].is_cancelled;
+}
+
+template<typename Payload>
+template<std::invocable<Payload &> Fire>
+std::size_t timer_wheel<Payload>::advance(double seconds, Fire && fire)
+{
+    pending_ticks += std::max(seconds, 0.)/tick_seconds;
+    const double whole_ticks = std::floor(pending_ticks);
+    pending_ticks -= whole_ticks;
+
+    std::size_t num_fired = 0;
+    for (auto ticks = static_cast<std::uint64_t>(whole_ticks); ticks > 0;) {
+        // nothing happens until the next tick a non-empty wheel comes around, so skip to it
+        std::uint32_t num_empty = 0;
+        while (num_empty < num_levels and level_sizes[num_empty] == 0) {
+            ++num_empty;
+        }
+        std::uint64_t idle_ticks = ticks;
+        if (num_empty < num_levels) {
+            const std::uint64_t span = std::uint64_t{1} << (slot_bits*num_empty);
+            idle_ticks = std::min(span - 1 - (current_tick & (span - 1)), ticks);
+        }
+        current_tick += idle_ticks;
+        ticks -= idle_ticks;
+        if (ticks == 0) {
+            break;
+        }
+        ++current_tick;
+        --ticks;
+        num_fired += fire_tick(fire);
+    }
+    return num_fired;
+}
+
+template<typename Payload>
+std::size_t timer_wheel<Payload>::advance(double seconds, std::vector<Payload> & ready)
+{
+    return advance(seconds, [&ready](Payload & payload) { ready.push_back(payload); });
+}
+
+template<typename Payload>
+std::size_t timer_wheel<Payload>::advance(double seconds) requires std::invocable<Payload &>
+{
+    return advance(seconds, [](Payload & payload) { payload(); });
+}
+
+template<typename Payload>
+void timer_wheel<Payload>::clear()
+{
+    for (std::uint32_t index = 0; index < timers.size(); ++index) {
+        if (timers[index].level != no_list and index != firing) {
+            unlink(index);
+            release(index);
+        }
+    }
+    if (firing != none) {
+        timers[firing].is_cancelled = true;
+    }
+    num_scheduled = 0;
+}
+
+template<typename Payload>
+std::uint64_t timer_wheel<Payload>::to_ticks(double seconds) const
+{
+    const double ticks = std::ceil(std::max(seconds, 0.)/tick_seconds - 1e-9);
+    return ticks >= static_cast<double>(std::numeric_limits<std::uint64_t>::max()/2)
+         ? std::numeric_limits<std::uint64_t>::max()/2 : static_cast<std::uint64_t>(ticks);
+}
+
+template<typename Payload>
+void timer_wheel<Payload>::place(std::uint32_t index)
+{
+    timer & placed = timers[index];
+
+    // timers further out than the wheels reach wait in the furthest slot, and are placed again
+    // when it comes around
+    const std::uint64_t delay = placed.deadline - current_tick;
+    const std::uint64_t slot_tick = delay > max_delay? current_tick + max_delay : placed.deadline;
+
+    std::uint32_t level = 0;
+    while (level + 1 < num_levels and (slot_tick - current_tick) >> (slot_bits*(level + 1)) != 0) {
+        ++level;
+    }
+    const auto slot = static_cast<std::uint32_t>((slot_tick >> (slot_bits*level)) & (num_slots - 1));
+    std::uint32_t & head = slots[level][slot];
+    placed.prev = none;
+    placed.next = head;
+    placed.level = level;
+    placed.slot = slot;
+    ++level_sizes[level];
+    if (head != none) {
+        timers[head].prev = index;
+    }
+    head = index;
+}
+
+template<typename Payload>
+void timer_wheel<Payload>::unlink(std::uint32_t index)
+{
+    timer & unlinked = timers[index];
+    if (unlinked.prev != none) {
+        timers[unlinked.prev].next = unlinked.next;
+    } else {
+        head_of(unlinked) = unlinked.next;
+    }
+    if (unlinked.next != none) {
+        timers[unlinked.next].prev = unlinked.prev;
+    }
+    if (unlinked.level < num_levels) {
+        --level_sizes[unlinked.level];
+    }
+    unlinked.prev = unlinked.next = none;
+    unlinked.level = no_list;
+}
+
+template<typename Payload>
+std::uint32_t & timer_wheel<Payload>::head_of(timer const & linked)
+{
+    return linked.level == due_list? due : slots[linked.level][linked.slot];
+}
+
+template<typename Payload>
+void timer_wheel<Payload>::release(std::uint32_t index)
+{
+    timer & released = timers[index];
+    released.payload = Payload{};
+    released.is_cancelled = false;
+    ++released.generation;
+    free_timers.push_back(index);
+}
+
+template<typename Payload>
+std::uint32_t timer_wheel<Payload>::take(std::uint32_t & head)
+{
+    const std::uint32_t first = head;
+    for (std::uint32_t index = first; index != none; index = timers[index].next) {
+        --level_sizes[timers[index].level];
+        timers[index].level = no_list;
+    }
+    head = none;
+    return first;
+}
+
+template<typename Payload>
+template<typename Fire>
+std::size_t timer_wheel<Payload>::fire_tick(Fire & fire)
+{
+    // when a wheel comes back around, spread the next slot of the wheel above it into it,
+    // starting from the top so that timers can fall more than one level
+    for (std::uint32_t level = num_levels - 1; level > 0; --level) {
+        const std::uint64_t lower_bits = current_tick & ((std::uint64_t{1} << (slot_bits*level)) - 1);
+        if (lower_bits != 0) {
+            continue;
+        }
+        auto & head = slots[level][(current_tick >> (slot_bits*level)) & (num_slots - 1)];
+        for (std::uint32_t index = take(head); index != none;) {
+            const std::uint32_t next = timers[index].next;
+            place(index);
+            index = next;
+        }
+    }
+
+    // the due timers are kept in a list of their own while they're fired, so that firing can
+    // still cancel the ones that haven't been fired yet
+    std::size_t num_fired = 0;
+    auto & slot = slots[0][current_tick & (num_slots - 1)];
+    due = take(slot);
+    for (std::uint32_t index = due; index != none; index = timers[index].next) {
+        timers[index].level = due_list;
+    }
+    while (due != none) {
+        const std::uint32_t index = due;
+        unlink(index);
+        timer & fired = timers[index];
+
+        firing = index;
+        fire(fired.payload);
+        firing = none;
+        ++num_fired;
+
+        // repeating timers are placed again, unless they were cancelled while being fired
+        if (fired.period != 0 and not fired.is_cancelled) {
+            fired.deadline = std::max(fired.deadline + fired.period, current_tick + 1);
+            place(index);
+        } else {
+            if (not fired.is_cancelled) {
+                --num_scheduled;
+            }
+            release(index);
+        }
+    }
+    return num_fired;
+}
+
+}
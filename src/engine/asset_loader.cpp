@@ -0,0 +1,163 @@
+#include "ion/engine/asset_loader.hpp"
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_render.h>
+#include <SDL3/SDL_surface.h>
+
+#include <algorithm>
+
+std::size_t ion::asset_loader::default_num_workers()
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+}
+
+ion::asset_loader::asset_loader(std::size_t num_workers)
+{
+    workers.reserve(std::max<std::size_t>(num_workers, 1));
+    for (std::size_t i = 0; i < std::max<std::size_t>(num_workers, 1); ++i)
+    {
+        workers.emplace_back([this](std::stop_token stop) { decode_requests(stop); });
+    }
+}
+
+ion::asset_loader::~asset_loader()
+{
+    for (auto & worker : workers) { worker.request_stop(); }
+    queue_changed.notify_all();
+    workers.clear();
+
+    // anything left in the queue will never be decoded, so wake up whoever is waiting on it
+    while (not decode_queue.empty())
+    {
+        auto & request = *decode_queue.top();
+        auto expected = asset_status::queued;
+        request.status.compare_exchange_strong(expected, asset_status::cancelled);
+        request.status.notify_all();
+        decode_queue.pop();
+    }
+}
+
+ion::surface_handle ion::asset_loader::load_surface(std::string_view path, int priority,
+                                                   const surface_params & params)
+{
+    return surface_handle{ enqueue(path, priority, params, false) };
+}
+
+ion::texture_handle ion::asset_loader::load_texture(std::string_view path, int priority)
+{
+    return texture_handle{ enqueue(path, priority, {}, true) };
+}
+
+std::shared_ptr<ion::internal::asset_request>
+ion::asset_loader::enqueue(std::string_view path, int priority,
+                           const surface_params & params, bool wants_texture)
+{
+    auto request = std::make_shared<internal::asset_request>();
+    request->path = path;
+    request->params = params;
+    request->priority = priority;
+    request->wants_texture = wants_texture;
+    {
+        std::scoped_lock lock{ queue_mutex };
+        request->sequence = num_requests++;
+        decode_queue.push(request);
+    }
+    queue_changed.notify_one();
+    return request;
+}
+
+bool ion::asset_loader::decode_order::operator()(const request_ptr & lhs, const request_ptr & rhs) const
+{
+    // the priority queue pops the greatest element, so the "lesser" request is the one with the
+    // lower priority, or the later one if they're the same
+    if (lhs->priority != rhs->priority) { return lhs->priority < rhs->priority; }
+    return lhs->sequence > rhs->sequence;
+}
+
+void ion::asset_loader::decode_requests(std::stop_token stop)
+{
+    while (not stop.stop_requested())
+    {
+        std::shared_ptr<internal::asset_request> request;
+        {
+            std::unique_lock lock{ queue_mutex };
+            if (not queue_changed.wait(lock, stop, [this] { return not decode_queue.empty(); }))
+            {
+                return;
+            }
+            request = decode_queue.top();
+            decode_queue.pop();
+        }
+        // skip requests that were cancelled, or that nobody holds a handle to anymore
+        auto expected = asset_status::queued;
+        if (request.use_count() == 1 or
+            not request->status.compare_exchange_strong(expected, asset_status::decoding))
+        {
+            continue;
+        }
+
+        request->surface = load_bitmap(request->path);
+        if (not request->surface)
+        {
+            SDL_Log("Couldn't load asset at %s: %s\n", request->path.c_str(), SDL_GetError());
+            request->status.store(asset_status::failed, std::memory_order_release);
+            request->status.notify_all();
+            continue;
+        }
+        if (const auto format = request->params.format;
+            format != SDL_PIXELFORMAT_UNKNOWN and format != request->surface->format)
+        {
+            request->surface = sdl_surface{ SDL_ConvertSurface(request->surface.get(), format), {} };
+            if (not request->surface)
+            {
+                SDL_Log("Couldn't convert asset at %s: %s\n", request->path.c_str(), SDL_GetError());
+                request->status.store(asset_status::failed, std::memory_order_release);
+                request->status.notify_all();
+                continue;
+            }
+        }
+        request->status.store(asset_status::decoded, std::memory_order_release);
+        request->status.notify_all();
+
+        if (request->wants_texture)
+        {
+            std::scoped_lock lock{ upload_mutex };
+            upload_queue.push_back(std::move(request));
+        }
+    }
+}
+
+std::size_t ion::asset_loader::upload(SDL_Renderer * renderer, std::size_t max_uploads)
+{
+    std::size_t num_uploaded = 0;
+    while (num_uploaded < max_uploads)
+    {
+        std::shared_ptr<internal::asset_request> request;
+        {
+            std::scoped_lock lock{ upload_mutex };
+            if (upload_queue.empty()) { break; }
+            request = std::move(upload_queue.front());
+            upload_queue.pop_front();
+        }
+        // don't spend the frame's budget on textures nobody wants anymore
+        if (request.use_count() == 1) { continue; }
+
+        request->texture = create_texture(renderer, request->surface.get());
+        if (not request->texture)
+        {
+            SDL_Log("Couldn't upload asset at %s: %s\n", request->path.c_str(), SDL_GetError());
+            request->status.store(asset_status::failed, std::memory_order_release);
+            continue;
+        }
+        request->surface.reset();
+        request->status.store(asset_status::uploaded, std::memory_order_release);
+        ++num_uploaded;
+    }
+    return num_uploaded;
+}
+
+std::size_t ion::asset_loader::num_pending() const
+{
+    std::scoped_lock lock{ queue_mutex, upload_mutex };
+    return decode_queue.size() + upload_queue.size();
+}
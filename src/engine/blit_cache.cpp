@@ -0,0 +1,155 @@
+#include "ion/engine/blit_cache.hpp"
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_surface.h>
+
+#include <cstring>
+#include <functional>
+
+namespace
+{
+/** The format to convert a surface to so it blits onto the destination without losing alpha */
+SDL_PixelFormat blit_format(SDL_PixelFormat destination, const SDL_Surface & source)
+{
+    if (destination == SDL_PIXELFORMAT_UNKNOWN) { return source.format; }
+    if (not SDL_ISPIXELFORMAT_ALPHA(source.format) or SDL_ISPIXELFORMAT_ALPHA(destination))
+    {
+        return destination;
+    }
+    // keep the destination's color layout and put alpha in the unused bits, so blending is a
+    // same-layout blit - and fall back to a common alpha format if there are no unused bits
+    const auto * details = SDL_GetPixelFormatDetails(destination);
+    if (details and details->bits_per_pixel == 32)
+    {
+        const std::uint32_t alpha_mask = ~(details->Rmask | details->Gmask | details->Bmask);
+        const auto format = SDL_GetPixelFormatForMasks(32, details->Rmask, details->Gmask,
+                                                       details->Bmask, alpha_mask);
+        if (format != SDL_PIXELFORMAT_UNKNOWN) { return format; }
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
+/** Copy a surface rotated by a number of quarter turns clockwise */
+ion::sdl_surface rotated(SDL_Surface * source, int quarter_turns)
+{
+    const bool is_sideways = quarter_turns % 2 == 1;
+    const int width = is_sideways? source->h : source->w;
+    const int height = is_sideways? source->w : source->h;
+
+    ion::sdl_surface rotation{ SDL_CreateSurface(width, height, source->format), {} };
+    if (not rotation) { return rotation; }
+
+    const auto * details = SDL_GetPixelFormatDetails(source->format);
+    const int pixel_size = details->bytes_per_pixel;
+    SDL_LockSurface(source);
+    SDL_LockSurface(rotation.get());
+    for (int y = 0; y < source->h; ++y)
+    {
+        const auto * row = static_cast<const std::uint8_t *>(source->pixels) + y*source->pitch;
+        for (int x = 0; x < source->w; ++x)
+        {
+            int to_x = x;
+            int to_y = y;
+            switch (quarter_turns)
+            {
+            case 1: to_x = source->h - 1 - y; to_y = x; break;
+            case 2: to_x = source->w - 1 - x; to_y = source->h - 1 - y; break;
+            case 3: to_x = y; to_y = source->w - 1 - x; break;
+            default: break;
+            }
+            auto * pixel = static_cast<std::uint8_t *>(rotation->pixels) + to_y*rotation->pitch + to_x*pixel_size;
+            std::memcpy(pixel, row + x*pixel_size, static_cast<std::size_t>(pixel_size));
+        }
+    }
+    SDL_UnlockSurface(rotation.get());
+    SDL_UnlockSurface(source);
+
+    std::uint32_t color_key;
+    if (SDL_GetSurfaceColorKey(source, &color_key)) { SDL_SetSurfaceColorKey(rotation.get(), true, color_key); }
+    return rotation;
+}
+}
+
+ion::blit_cache::~blit_cache()
+{
+    clear();
+}
+
+std::size_t ion::blit_cache::variant_hash::operator()(const variant_key & key) const noexcept
+{
+    std::size_t hash = std::hash<const void *>{}(key.source);
+    for (const int value : { key.width, key.height, key.quarter_turns })
+    {
+        hash ^= std::hash<int>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+void ion::blit_cache::format(SDL_PixelFormat destination_format)
+{
+    if (destination_format == this->destination_format) { return; }
+    clear();
+    this->destination_format = destination_format;
+}
+
+SDL_Surface * ion::blit_cache::prepared(SDL_Surface * source, int width, int height, int quarter_turns)
+{
+    if (not source or width <= 0 or height <= 0) { return nullptr; }
+    quarter_turns = ((quarter_turns % 4) + 4) % 4;
+
+    const variant_key key{ source, width, height, quarter_turns };
+    if (const auto search = variants.find(key); search != variants.end())
+    {
+        return search->second.get();
+    }
+
+    // convert and scale before rotating, so the rotation copies the fewest pixels it can
+    sdl_surface variant{ SDL_ConvertSurface(source, blit_format(destination_format, *source)), {} };
+    const bool is_sideways = quarter_turns % 2 == 1;
+    const int scaled_width = is_sideways? height : width;
+    const int scaled_height = is_sideways? width : height;
+    if (variant and (variant->w != scaled_width or variant->h != scaled_height))
+    {
+        variant = sdl_surface{ SDL_ScaleSurface(variant.get(), scaled_width, scaled_height, SDL_SCALEMODE_NEAREST), {} };
+    }
+    if (variant and quarter_turns != 0)
+    {
+        variant = rotated(variant.get(), quarter_turns);
+    }
+    if (not variant)
+    {
+        SDL_Log("Couldn't prepare a surface to blit: %s\n", SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetSurfaceBlendMode(variant.get(), SDL_ISPIXELFORMAT_ALPHA(variant->format)? SDL_BLENDMODE_BLEND
+                                                                                   : SDL_BLENDMODE_NONE);
+
+    // hold on to the source so its address can't be reused by another surface while it's a key
+    ++source->refcount;
+    return variants.try_emplace(key, std::move(variant)).first->second.get();
+}
+
+std::uint32_t ion::blit_cache::map(const SDL_Color & color)
+{
+    const std::uint32_t rgba = (static_cast<std::uint32_t>(color.r) << 24) | (static_cast<std::uint32_t>(color.g) << 16)
+                             | (static_cast<std::uint32_t>(color.b) << 8) | static_cast<std::uint32_t>(color.a);
+    if (const auto search = mapped_colors.find(rgba); search != mapped_colors.end())
+    {
+        return search->second;
+    }
+    const auto * details = SDL_GetPixelFormatDetails(destination_format);
+    const std::uint32_t pixel = SDL_MapRGBA(details, nullptr, color.r, color.g, color.b, color.a);
+    mapped_colors.emplace(rgba, pixel);
+    return pixel;
+}
+
+void ion::blit_cache::clear()
+{
+    for (const auto & [key, variant] : variants)
+    {
+        // releases the reference taken in prepared
+        SDL_DestroySurface(key.source);
+    }
+    variants.clear();
+    mapped_colors.clear();
+}
@@ -0,0 +1,173 @@
+#include "ion/engine/chunked_tile_layer.hpp"
+#include "ion/engine/quad_geometry.hpp"
+
+#include <SDL3/SDL_log.h>
+
+#include <algorithm>
+
+namespace
+{
+// round towards negative infinity, so that cells left of and above 0, 0 get their own chunks
+int floor_div(int value, int divisor)
+{
+    const int quotient = value/divisor;
+    return (value % divisor != 0 and (value < 0) != (divisor < 0))? quotient - 1 : quotient;
+}
+}
+
+ion::chunked_tile_layer::chunked_tile_layer(int tile_size, int chunk_tiles)
+    : cell_size{ std::max(tile_size, 1) }, chunk_tiles{ std::max(chunk_tiles, 1) }
+{
+}
+
+std::uint64_t ion::chunked_tile_layer::chunk_key(int chunk_x, int chunk_y)
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunk_x)) << 32)
+         | static_cast<std::uint32_t>(chunk_y);
+}
+
+void ion::chunked_tile_layer::atlas(const texture_atlas * atlas)
+{
+    if (atlas == tile_atlas) { return; }
+    tile_atlas = atlas;
+    invalidate();
+}
+
+void ion::chunked_tile_layer::tile_size(int size)
+{
+    size = std::max(size, 1);
+    if (size == cell_size) { return; }
+    cell_size = size;
+
+    // the textures are the wrong size now, so they have to be created again too
+    for (auto & [key, baked] : chunks)
+    {
+        baked.texture.reset();
+        baked.is_dirty = true;
+    }
+}
+
+void ion::chunked_tile_layer::place(int x, int y, std::uint32_t tile, const SDL_Color & fill)
+{
+    const int chunk_x = floor_div(x, chunk_tiles);
+    const int chunk_y = floor_div(y, chunk_tiles);
+    auto & placed = chunks[chunk_key(chunk_x, chunk_y)];
+    if (placed.cells.empty()) { placed.cells.resize(static_cast<std::size_t>(chunk_tiles)*chunk_tiles); }
+
+    auto & target = placed.cells[static_cast<std::size_t>(y - chunk_y*chunk_tiles)*chunk_tiles
+                                 + (x - chunk_x*chunk_tiles)];
+    if (not target.is_set)
+    {
+        ++placed.num_set;
+        ++num_cells;
+    }
+    target = cell{ tile, fill, true };
+    placed.is_dirty = true;
+}
+
+void ion::chunked_tile_layer::erase(int x, int y)
+{
+    const int chunk_x = floor_div(x, chunk_tiles);
+    const int chunk_y = floor_div(y, chunk_tiles);
+    const auto found = chunks.find(chunk_key(chunk_x, chunk_y));
+    if (found == chunks.end()) { return; }
+
+    auto & target = found->second.cells[static_cast<std::size_t>(y - chunk_y*chunk_tiles)*chunk_tiles
+                                        + (x - chunk_x*chunk_tiles)];
+    if (not target.is_set) { return; }
+    target.is_set = false;
+    --num_cells;
+    if (--found->second.num_set == 0) { chunks.erase(found); }
+    else { found->second.is_dirty = true; }
+}
+
+void ion::chunked_tile_layer::clear()
+{
+    chunks.clear();
+    num_cells = 0;
+}
+
+void ion::chunked_tile_layer::invalidate()
+{
+    for (auto & [key, baked] : chunks) { baked.is_dirty = true; }
+}
+
+void ion::chunked_tile_layer::render(SDL_Renderer * renderer, const SDL_FPoint & origin)
+{
+    int width = 0, height = 0;
+    if (not SDL_GetCurrentRenderOutputSize(renderer, &width, &height)) { return; }
+    const SDL_FRect output{ 0.f, 0.f, static_cast<float>(width), static_cast<float>(height) };
+
+    const float chunk_size = static_cast<float>(chunk_tiles*cell_size);
+    for (auto & [key, baked] : chunks)
+    {
+        const auto chunk_x = static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32));
+        const auto chunk_y = static_cast<std::int32_t>(static_cast<std::uint32_t>(key));
+        const SDL_FRect dst{ origin.x + static_cast<float>(chunk_x)*chunk_size,
+                             origin.y + static_cast<float>(chunk_y)*chunk_size,
+                             chunk_size, chunk_size };
+
+        // chunks that aren't visible stay dirty until they are
+        if (not SDL_HasRectIntersectionFloat(&dst, &output)) { continue; }
+        if (baked.is_dirty and not bake(renderer, baked)) { continue; }
+        SDL_RenderTexture(renderer, baked.texture.get(), nullptr, &dst);
+    }
+}
+
+bool ion::chunked_tile_layer::bake(SDL_Renderer * renderer, chunk & baked)
+{
+    const int size = chunk_tiles*cell_size;
+    if (not baked.texture)
+    {
+        baked.texture = sdl_texture{ SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                                       SDL_TEXTUREACCESS_TARGET, size, size), {} };
+        if (not baked.texture)
+        {
+            SDL_Log("Couldn't create a texture for a tile chunk: %s\n", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureScaleMode(baked.texture.get(), SDL_SCALEMODE_NEAREST);
+        SDL_SetTextureBlendMode(baked.texture.get(), SDL_BLENDMODE_BLEND);
+    }
+
+    // each cell is a fill and a tile in the same call, sampling the atlas' white texels for the fill
+    vertices.clear();
+    indices.clear();
+    const SDL_FRect white = tile_atlas? tile_atlas->white_uv() : SDL_FRect{ 0.f, 0.f, 0.f, 0.f };
+    const auto tile_size = static_cast<float>(cell_size);
+    for (int y = 0; y < chunk_tiles; ++y)
+    {
+        for (int x = 0; x < chunk_tiles; ++x)
+        {
+            const cell & baked_cell = baked.cells[static_cast<std::size_t>(y)*chunk_tiles + x];
+            if (not baked_cell.is_set) { continue; }
+
+            const SDL_FRect dst{ static_cast<float>(x)*tile_size, static_cast<float>(y)*tile_size,
+                                 tile_size, tile_size };
+            push_quad(vertices, indices, dst, white, to_fcolor(baked_cell.fill));
+            if (const SDL_FRect * uv = tile_atlas? tile_atlas->uv_for(baked_cell.tile) : nullptr)
+            {
+                push_quad(vertices, indices, dst, *uv, to_fcolor({ 0xff, 0xff, 0xff, 0xff }));
+            }
+        }
+    }
+
+    SDL_Texture * previous_target = SDL_GetRenderTarget(renderer);
+    if (not SDL_SetRenderTarget(renderer, baked.texture.get()))
+    {
+        SDL_Log("Couldn't draw to a tile chunk: %s\n", SDL_GetError());
+        return false;
+    }
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_SetRenderDrawColor(renderer, 0x0, 0x0, 0x0, 0x0);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+    SDL_RenderGeometry(renderer, tile_atlas? tile_atlas->texture() : nullptr,
+                       vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+    SDL_SetRenderTarget(renderer, previous_target);
+    baked.is_dirty = false;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "ion/engine/dirty_region.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+SDL_Rect union_of(const SDL_Rect & lhs, const SDL_Rect & rhs)
+{
+    SDL_Rect result;
+    SDL_GetRectUnion(&lhs, &rhs, &result);
+    return result;
+}
+
+long long area_of(const SDL_Rect & rect)
+{
+    return static_cast<long long>(rect.w)*static_cast<long long>(rect.h);
+}
+}
+
+ion::dirty_region::dirty_region(std::size_t max_rects)
+    : max_rects{ std::max<std::size_t>(max_rects, 1) }
+{
+    dirty_rects.reserve(this->max_rects);
+}
+
+void ion::dirty_region::bounds(const SDL_Rect & bounds)
+{
+    if (SDL_RectsEqual(&bounds, &area)) { return; }
+    area = bounds;
+    mark_all();
+}
+
+void ion::dirty_region::mark(const SDL_Rect & rect)
+{
+    SDL_Rect dirty;
+    if (not SDL_GetRectIntersection(&rect, &area, &dirty)) { return; }
+
+    // absorb every rect the new one overlaps, and keep going since the union may overlap more
+    for (auto overlapping = dirty_rects.begin(); overlapping != dirty_rects.end();)
+    {
+        if (SDL_HasRectIntersection(&dirty, &*overlapping))
+        {
+            dirty = union_of(dirty, *overlapping);
+            dirty_rects.erase(overlapping);
+            overlapping = dirty_rects.begin();
+        }
+        else { ++overlapping; }
+    }
+    if (dirty_rects.size() < max_rects)
+    {
+        dirty_rects.push_back(dirty);
+        return;
+    }
+
+    // merge into the rect that grows the least, then fold in anything the merged rect overlaps
+    const auto cheapest = std::ranges::min_element(dirty_rects, {}, [&](const SDL_Rect & existing)
+    {
+        return area_of(union_of(dirty, existing)) - area_of(existing);
+    });
+    const SDL_Rect merged = union_of(dirty, *cheapest);
+    dirty_rects.erase(cheapest);
+    mark(merged);
+}
+
+void ion::dirty_region::mark_all()
+{
+    dirty_rects.clear();
+    if (not SDL_RectEmpty(&area)) { dirty_rects.push_back(area); }
+}
@@ -0,0 +1,164 @@
+#include "ion/engine/dispatch_profiler.hpp"
+
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+
+namespace
+{
+bool profiler_enabled = false;
+std::uint32_t polls_per_dump = 0;
+std::uint32_t polls_since_dump = 0;
+std::uint64_t next_listener_id = 1;
+
+// listeners that were profiled are kept after they're disconnected, so their profile
+// outlives them until the profiler is reset
+std::vector<std::unique_ptr<ion::internal::profiled_listener>> profiled_listeners;
+
+bool can_free(const ion::internal::profiled_listener & listener)
+{
+    return not listener.is_connected and listener.active_calls == 0;
+}
+
+void disconnect(ion::internal::profiled_listener & listener)
+{
+    listener.disconnect();
+    listener.is_connected = false;
+}
+}
+
+void ion::event_connection::release()
+{
+    // the wrapper is tracked until it's forgotten, so it's disconnected through the profiler
+    if (profiled_id != 0)
+    {
+        internal::forget(profiled_id);
+        profiled_id = 0;
+    }
+    connection.release();
+}
+
+void ion::dispatch_profiler::enable(bool enabled)
+{
+    profiler_enabled = enabled;
+}
+
+bool ion::dispatch_profiler::is_enabled()
+{
+    return profiler_enabled;
+}
+
+std::vector<ion::listener_profile> ion::dispatch_profiler::table()
+{
+    std::vector<listener_profile> profiles;
+    profiles.reserve(profiled_listeners.size());
+    for (const auto & listener : profiled_listeners)
+    {
+        // every listener is tracked, but only the ones called while profiling are worth listing
+        if (listener->profile.calls > 0)
+        {
+            profiles.push_back(listener->profile);
+        }
+    }
+    std::ranges::sort(profiles, std::ranges::greater{}, &listener_profile::total_ns);
+    return profiles;
+}
+
+void ion::dispatch_profiler::dump()
+{
+    SDL_Log("%-12s %10s %12s %12s %12s  %s\n",
+            "event", "calls", "total (us)", "mean (us)", "max (us)", "listener");
+    for (const auto & profile : table())
+    {
+        const double mean_ns = profile.calls > 0
+                             ? static_cast<double>(profile.total_ns)/static_cast<double>(profile.calls)
+                             : 0.;
+        SDL_Log("%-12.*s %10llu %12.1f %12.2f %12.2f  %.*s\n",
+                static_cast<int>(profile.event.size()), profile.event.data(),
+                static_cast<unsigned long long>(profile.calls),
+                static_cast<double>(profile.total_ns)/1000., mean_ns/1000.,
+                static_cast<double>(profile.max_ns)/1000.,
+                static_cast<int>(profile.listener.size()), profile.listener.data());
+    }
+}
+
+void ion::dispatch_profiler::dump_every(std::uint32_t num_polls)
+{
+    polls_per_dump = num_polls;
+    polls_since_dump = 0;
+}
+
+void ion::dispatch_profiler::reset()
+{
+    std::erase_if(profiled_listeners, [](const auto & listener) { return can_free(*listener); });
+    for (auto & listener : profiled_listeners)
+    {
+        listener->profile.calls = 0;
+        listener->profile.total_ns = 0;
+        listener->profile.max_ns = 0;
+    }
+}
+
+void ion::dispatch_profiler::end_poll()
+{
+    if (polls_per_dump == 0) { return; }
+    if (++polls_since_dump >= polls_per_dump)
+    {
+        dump();
+        polls_since_dump = 0;
+    }
+}
+
+ion::internal::profiled_listener &
+ion::internal::track(std::unique_ptr<profiled_listener> listener)
+{
+    // listeners that were never called while profiling have nothing worth keeping
+    std::erase_if(profiled_listeners, [](const auto & tracked)
+    {
+        return can_free(*tracked) and tracked->profile.calls == 0;
+    });
+    listener->id = next_listener_id++;
+    return *profiled_listeners.emplace_back(std::move(listener));
+}
+
+void ion::internal::forget(std::uint64_t id)
+{
+    const auto tracked = std::ranges::find(profiled_listeners, id, [](const auto & listener) { return listener->id; });
+    if (tracked != profiled_listeners.end() and (*tracked)->is_connected)
+    {
+        disconnect(**tracked);
+    }
+}
+
+void ion::internal::forget(const void * signal, std::string_view listener, const void * instance)
+{
+    for (auto & tracked : profiled_listeners)
+    {
+        if (tracked->is_connected and tracked->signal == signal and tracked->instance == instance
+                                  and tracked->profile.listener == listener)
+        {
+            disconnect(*tracked);
+        }
+    }
+}
+
+void ion::internal::forget_all(const void * signal, const void * instance)
+{
+    for (auto & tracked : profiled_listeners)
+    {
+        if (tracked->is_connected and tracked->signal == signal and tracked->instance == instance)
+        {
+            disconnect(*tracked);
+        }
+    }
+}
+
+void ion::internal::forget_all(const void * signal)
+{
+    for (auto & tracked : profiled_listeners)
+    {
+        if (tracked->is_connected and tracked->signal == signal)
+        {
+            disconnect(*tracked);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "ion/engine/quad_batch.hpp"
+#include "ion/engine/quad_geometry.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+void ion::quad_batch::push(const SDL_FRect & dst, const SDL_Color & color, SDL_BlendMode blend_mode)
+{
+    auto & quads = group_for(nullptr, blend_mode);
+    push_quad(quads.vertices, quads.indices, dst, SDL_FRect{ 0.f, 0.f, 0.f, 0.f }, to_fcolor(color));
+}
+
+void ion::quad_batch::push(const SDL_FRect & dst, SDL_Texture * texture, const SDL_FRect & uv,
+                           const SDL_Color & tint, SDL_BlendMode blend_mode)
+{
+    auto & quads = group_for(texture, blend_mode);
+    push_quad(quads.vertices, quads.indices, dst, uv, to_fcolor(tint));
+}
+
+void ion::quad_batch::reserve(std::size_t num_quads, SDL_Texture * texture, SDL_BlendMode blend_mode)
+{
+    auto & quads = group_for(texture, blend_mode);
+    quads.vertices.reserve(quads.vertices.size() + num_quads*4);
+    quads.indices.reserve(quads.indices.size() + num_quads*6);
+}
+
+ion::quad_batch::group & ion::quad_batch::group_for(SDL_Texture * texture, SDL_BlendMode blend_mode)
+{
+    const auto search = std::ranges::find_if(groups, [=](const group & quads)
+    {
+        return quads.texture == texture and quads.blend_mode == blend_mode;
+    });
+    if (search != groups.end()) { return *search; }
+    return groups.emplace_back(group{ texture, blend_mode, {}, {} });
+}
+
+void ion::quad_batch::flush(SDL_Renderer * renderer)
+{
+    // forget the groups that weren't used since the last flush, so textures that come and go
+    // don't pile up, but keep the buffers of the ones that were
+    std::erase_if(groups, [](const group & quads) { return quads.indices.empty(); });
+
+    // solid quads first, then by texture and blend mode
+    std::ranges::sort(groups, [](const group & lhs, const group & rhs)
+    {
+        if (lhs.texture != rhs.texture) { return std::less<>{}(lhs.texture, rhs.texture); }
+        return lhs.blend_mode < rhs.blend_mode;
+    });
+
+    SDL_BlendMode draw_blend_mode;
+    SDL_GetRenderDrawBlendMode(renderer, &draw_blend_mode);
+    for (auto & [texture, blend_mode, vertices, indices] : groups)
+    {
+        // solid geometry blends with the renderer's draw blend mode, textured geometry with the texture's
+        if (texture) { SDL_SetTextureBlendMode(texture, blend_mode); }
+        else { SDL_SetRenderDrawBlendMode(renderer, blend_mode); }
+
+        SDL_RenderGeometry(renderer, texture,
+                           vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size()));
+    }
+    SDL_SetRenderDrawBlendMode(renderer, draw_blend_mode);
+    clear();
+}
+
+void ion::quad_batch::clear()
+{
+    for (auto & quads : groups)
+    {
+        quads.vertices.clear();
+        quads.indices.clear();
+    }
+}
+
+std::size_t ion::quad_batch::size() const
+{
+    return std::accumulate(groups.begin(), groups.end(), std::size_t{ 0 }, [](std::size_t sum, const group & quads)
+    {
+        return sum + quads.indices.size()/6;
+    });
+}
@@ -0,0 +1,120 @@
+#include "ion/engine/resource_cache.hpp"
+
+#include <SDL3/SDL_surface.h>
+
+#include <algorithm>
+#include <functional>
+
+ion::resource_cache::resource_cache(asset_loader & loader, std::size_t byte_budget)
+    : loader{ &loader }, byte_budget{ byte_budget }
+{
+}
+
+std::size_t ion::resource_cache::key_hash::operator()(const key & k) const noexcept
+{
+    const std::size_t path_hash = std::hash<std::string>{}(k.path);
+    const std::size_t format_hash = std::hash<std::uint32_t>{}(static_cast<std::uint32_t>(k.params.format));
+    return path_hash ^ (format_hash + 0x9e3779b9 + (path_hash << 6) + (path_hash >> 2));
+}
+
+ion::surface_handle ion::resource_cache::load_surface(std::string_view path,
+                                                      const surface_params & params, int priority)
+{
+    key id{ std::string{ path }, params };
+    if (const auto search = lookup.find(id); search != lookup.end())
+    {
+        ++num_hits;
+        entries.splice(entries.begin(), entries, search->second);
+        return search->second->surface;
+    }
+    ++num_misses;
+    entries.push_front(entry{ id, loader->load_surface(path, priority, params) });
+    lookup.emplace(std::move(id), entries.begin());
+    unsized.push_back(entries.begin());
+
+    trim();
+    return entries.front().surface;
+}
+
+void ion::resource_cache::budget(std::size_t byte_budget)
+{
+    this->byte_budget = byte_budget;
+    trim();
+}
+
+void ion::resource_cache::trim()
+{
+    measure_pending();
+    evict_unused(byte_budget);
+}
+
+void ion::resource_cache::clear()
+{
+    measure_pending();
+    for (auto cached = entries.begin(); cached != entries.end();)
+    {
+        if (is_evictable(*cached)) { evict(cached++); }
+        else { ++cached; }
+    }
+}
+
+ion::resource_cache::statistics ion::resource_cache::stats()
+{
+    measure_pending();
+    return { num_hits, num_misses, num_evictions, num_bytes, entries.size() };
+}
+
+void ion::resource_cache::reset_stats()
+{
+    num_hits = 0;
+    num_misses = 0;
+    num_evictions = 0;
+}
+
+bool ion::resource_cache::is_evictable(const entry & cached) const
+{
+    // the cache holds one handle itself, so any other handle means the surface is in use
+    return cached.is_sized and cached.surface.use_count() == 1;
+}
+
+void ion::resource_cache::evict(entry_list::iterator cached)
+{
+    num_bytes -= cached->bytes;
+    ++num_evictions;
+    lookup.erase(cached->id);
+    entries.erase(cached);
+}
+
+void ion::resource_cache::measure_pending()
+{
+    std::erase_if(unsized, [this](entry_list::iterator cached)
+    {
+        if (not cached->surface.is_done()) { return false; }
+
+        // forget surfaces that failed to load so the next request tries again
+        const SDL_Surface * surface = cached->surface.get();
+        if (not surface)
+        {
+            lookup.erase(cached->id);
+            entries.erase(cached);
+            return true;
+        }
+        cached->bytes = static_cast<std::size_t>(surface->pitch) * static_cast<std::size_t>(surface->h);
+        cached->is_sized = true;
+        num_bytes += cached->bytes;
+        return true;
+    });
+}
+
+void ion::resource_cache::evict_unused(std::size_t target_bytes)
+{
+    // walk from the least recently used entry, skipping the ones that are still in use
+    for (auto cached = entries.end(); num_bytes > target_bytes and cached != entries.begin();)
+    {
+        --cached;
+        if (is_evictable(*cached))
+        {
+            evict(cached++);
+        }
+    }
+}
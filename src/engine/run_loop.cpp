@@ -0,0 +1,138 @@
+#include "ion/engine/run_loop.hpp"
+#include "ion/engine/sdl_events.hpp"
+#include "ion/engine/session.hpp"
+#include "ion/time/time_source.hpp"
+
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_render.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace
+{
+std::atomic<bool> redraw_requested = false;
+std::atomic<Uint32> wake_event_type = 0;
+
+// window events that mean the window's contents have to be drawn again
+constexpr std::array redraw_events{
+    SDL_EVENT_WINDOW_EXPOSED,
+    SDL_EVENT_WINDOW_RESIZED,
+    SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED
+};
+
+std::uint64_t period_for(double hz)
+{
+    return static_cast<std::uint64_t>(1'000'000'000.0/std::max(hz, 1.0));
+}
+}
+
+ion::run_loop::run_loop(mode loop_mode, std::uint64_t frame_period_ns, std::int32_t idle_timeout_ms)
+    : loop_mode{ loop_mode }, frame_period_ns{ frame_period_ns }, idle_timeout_ms{ idle_timeout_ms }
+{
+}
+
+ion::run_loop ion::run_loop::continuous()
+{
+    return run_loop{ mode::continuous, 0, 0 };
+}
+
+ion::run_loop ion::run_loop::vsync(SDL_Renderer * renderer)
+{
+    if (not renderer or not SDL_SetRenderVSync(renderer, 1))
+    {
+        SDL_Log("Couldn't turn on vsync, capping the frame rate instead: %s\n", SDL_GetError());
+        return capped(60.0);
+    }
+    return run_loop{ mode::vsync, 0, 0 };
+}
+
+ion::run_loop ion::run_loop::capped(double hz)
+{
+    return run_loop{ mode::capped, period_for(hz), 0 };
+}
+
+ion::run_loop ion::run_loop::on_demand(std::int32_t idle_timeout_ms)
+{
+    // register the event that request_redraw wakes blocked loops up with
+    if (wake_event_type.load(std::memory_order_acquire) == 0)
+    {
+        wake_event_type.store(SDL_RegisterEvents(1), std::memory_order_release);
+    }
+
+    // the loop reads the window events it redraws on straight from sdl's queue, so they have
+    // to stay in it even when sdl_events filters out what no sink listens to
+    for (const auto type : redraw_events) { sdl_events::observe(type, true); }
+    return run_loop{ mode::on_demand, 0, idle_timeout_ms };
+}
+
+void ion::run_loop::request_redraw()
+{
+    if (redraw_requested.exchange(true, std::memory_order_acq_rel)) { return; }
+
+    // only the first request since the last draw needs to wake anything up
+    if (const Uint32 type = wake_event_type.load(std::memory_order_acquire); type != 0)
+    {
+        SDL_Event wake{};
+        wake.type = type;
+        SDL_PushEvent(&wake);
+    }
+}
+
+void ion::run_loop::wait()
+{
+    switch (loop_mode)
+    {
+    case mode::continuous:
+    case mode::vsync:
+        return;
+
+    case mode::capped:
+    {
+        auto & time = time_source::current();
+        const std::uint64_t now = time.now_ns();
+        if (next_frame_ns == 0 or now >= next_frame_ns + frame_period_ns)
+        {
+            // don't try to catch up on frames that were missed by more than a frame
+            next_frame_ns = now + frame_period_ns;
+            return;
+        }
+        if (now < next_frame_ns) { time.sleep_ns(next_frame_ns - now); }
+        next_frame_ns += frame_period_ns;
+        return;
+    }
+    case mode::on_demand:
+        if (redraw_requested.load(std::memory_order_acquire) or session::is_replaying()) { break; }
+
+        SDL_WaitEventTimeout(nullptr, idle_timeout_ms);
+        break;
+    }
+    has_window_changed = has_window_changed or std::ranges::any_of(redraw_events, [](const auto type)
+    {
+        return SDL_HasEvent(type);
+    });
+}
+
+bool ion::run_loop::should_draw()
+{
+    if (loop_mode != mode::on_demand or session::is_replaying()) { return true; }
+    const bool requested = redraw_requested.exchange(false, std::memory_order_acq_rel);
+    const bool should = requested or has_window_changed;
+    has_window_changed = false;
+    return should;
+}
+
+bool ion::run_loop::poll()
+{
+    wait();
+
+    // the first iteration has nothing to measure from
+    const std::uint64_t now = time_source::current().now_ns();
+    const float measured_dt = last_poll_ns == 0 ? 0.f : static_cast<float>(now - last_poll_ns)/1e9f;
+    last_poll_ns = now;
+
+    frame_dt = session::poll(measured_dt);
+    return should_draw();
+}
\ No newline at end of file
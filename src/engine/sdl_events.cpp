@@ -1,20 +1,350 @@
 #include <ion/engine/sdl_events.hpp>
+
 #include <SDL3/SDL_events.h>
 
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <optional>
+#include <vector>
+
 entt::sigh<void(SDL_Event*)> ion::sdl_events::poll_signal{};
 entt::sigh<void()> ion::sdl_events::quit_signal{};
 entt::sigh<void(int)> ion::sdl_events::mouse_scroll_signal{};
 entt::sigh<void()> ion::sdl_events::mouse_up_signal{};
 entt::sigh<void(int, int)> ion::sdl_events::mouse_moved_signal{};
+entt::sigh<void(const SDL_MouseMotionEvent &)> ion::sdl_events::mouse_motion_signal{};
 entt::sigh<void(SDL_Keycode)> ion::sdl_events::key_up_signal{};
 entt::sigh<void(SDL_Keycode)> ion::sdl_events::key_down_signal{};
 
+entt::sigh<void(std::span<const SDL_Event>)> ion::sdl_events::event_batch_signal{};
+entt::sigh<void(std::span<const SDL_MouseMotionEvent>)> ion::sdl_events::mouse_moved_batch_signal{};
+entt::sigh<void(std::span<const SDL_MouseButtonEvent>)> ion::sdl_events::mouse_button_batch_signal{};
+entt::sigh<void(std::span<const SDL_MouseWheelEvent>)> ion::sdl_events::mouse_scroll_batch_signal{};
+entt::sigh<void(std::span<const SDL_KeyboardEvent>)> ion::sdl_events::key_batch_signal{};
+entt::sigh<void()> ion::sdl_events::polled_signal{};
+
+// the events of one poll or dispatch, and the buckets they're sorted into by type for the
+// batch sinks - these keep their memory between polls so that polling doesn't allocate once
+// it's warmed up
+struct ion::sdl_events::event_buffers
+{
+    std::vector<SDL_Event> events;
+    std::vector<SDL_MouseMotionEvent> mouse_motion;
+    std::vector<SDL_MouseButtonEvent> mouse_button;
+    std::vector<SDL_MouseWheelEvent> mouse_wheel;
+    std::vector<SDL_KeyboardEvent> key;
+};
+
+namespace
+{
+// a listener that polls or dispatches events gets buffers of its own, so that the events
+// that are still being published don't change underneath the poll that's publishing them
+std::deque<ion::sdl_events::event_buffers> buffer_pool;
+std::size_t buffers_in_use = 0;
+
+class buffers_lease
+{
+public:
+    buffers_lease()
+        : buffers{ buffers_in_use == buffer_pool.size()? buffer_pool.emplace_back() : buffer_pool[buffers_in_use] }
+    {
+        ++buffers_in_use;
+        buffers.events.clear();
+        buffers.mouse_motion.clear();
+        buffers.mouse_button.clear();
+        buffers.mouse_wheel.clear();
+        buffers.key.clear();
+    }
+    ~buffers_lease() { --buffers_in_use; }
+
+    buffers_lease(const buffers_lease &) = delete;
+    buffers_lease & operator=(const buffers_lease &) = delete;
+
+    ion::sdl_events::event_buffers & buffers;
+};
+
+void drain_sdl_queue(std::vector<SDL_Event> & events)
+{
+    int num_events = 0;
+    do
+    {
+        const std::size_t num_drained = events.size();
+        events.resize(num_drained + ion::sdl_events::max_batch_size);
+        num_events = SDL_PeepEvents(events.data() + num_drained, static_cast<int>(ion::sdl_events::max_batch_size),
+                                    SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST);
+        events.resize(num_drained + static_cast<std::size_t>(std::max(num_events, 0)));
+    } while (num_events > 0);
+}
+
+bool coalesce_mouse_motion = false;
+bool coalesce_mouse_wheel = false;
+
+SDL_MouseMotionEvent coalesced(std::span<const SDL_MouseMotionEvent> events)
+{
+    // keep the latest position and button state, but sum up the relative motion
+    SDL_MouseMotionEvent motion = events.back();
+    motion.xrel = 0.f;
+    motion.yrel = 0.f;
+    for (const auto & event : events)
+    {
+        motion.xrel += event.xrel;
+        motion.yrel += event.yrel;
+    }
+    return motion;
+}
+
+SDL_MouseWheelEvent coalesced(std::span<const SDL_MouseWheelEvent> events)
+{
+    SDL_MouseWheelEvent wheel = events.back();
+    wheel.x = 0.f;
+    wheel.y = 0.f;
+    for (const auto & event : events)
+    {
+        wheel.x += event.x;
+        wheel.y += event.y;
+    }
+    return wheel;
+}
+
+// the event types that a sink has listeners for
+struct observed_events
+{
+    bool everything = true;
+    bool mouse_motion = true;
+    bool mouse_button_down = true;
+    bool mouse_button_up = true;
+    bool mouse_wheel = true;
+    bool key_down = true;
+    bool key_up = true;
+
+    bool operator==(const observed_events & other) const = default;
+};
+
+// the event types sdl defines, other than quit, which is always queued - the types past these
+// are reserved for sdl itself and for the events a program registers, so they're left alone
+constexpr Uint32 first_filtered_event = SDL_EVENT_QUIT + 1;
+constexpr Uint32 last_filtered_event = SDL_EVENT_PRIVATE0 - 1;
+
+bool filter_unobserved_events = false;
+std::optional<observed_events> applied_event_filter;
+
+// the types that are observed without a sink, sorted
+std::vector<Uint32> observed_without_sink;
+
+bool passes_filter(const observed_events & observed, Uint32 type)
+{
+    if (observed.everything or std::ranges::binary_search(observed_without_sink, type)) { return true; }
+    switch (type)
+    {
+    case SDL_EVENT_MOUSE_MOTION:
+        return observed.mouse_motion;
+
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        return observed.mouse_button_down;
+
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        return observed.mouse_button_up;
+
+    case SDL_EVENT_MOUSE_WHEEL:
+        return observed.mouse_wheel;
+
+    case SDL_EVENT_KEY_DOWN:
+        return observed.key_down;
+
+    case SDL_EVENT_KEY_UP:
+        return observed.key_up;
+
+    default:
+        // ion doesn't publish any other type, so only raw listeners observe it
+        return false;
+    }
+}
+
+void apply_event_filter(const observed_events & observed)
+{
+    // sdl only does any work for the types whose state changes
+    for (Uint32 type = first_filtered_event; type <= last_filtered_event; ++type)
+    {
+        SDL_SetEventEnabled(type, passes_filter(observed, type));
+    }
+    applied_event_filter = observed;
+}
+
+}
+
 void ion::sdl_events::poll()
 {
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
+    refresh_event_filter();
+    buffers_lease lease;
+    SDL_PumpEvents();
+    drain_sdl_queue(lease.buffers.events);
+    publish(lease.buffers);
+}
+
+void ion::sdl_events::dispatch(std::span<const SDL_Event> events)
+{
+    // the events are copied, so whatever they came from may change while they're published
+    buffers_lease lease;
+    lease.buffers.events.assign(events.begin(), events.end());
+    publish(lease.buffers);
+}
+
+bool ion::sdl_events::coalesce(SDL_EventType type, bool enabled)
+{
+    switch (type)
+    {
+    case SDL_EVENT_MOUSE_MOTION:
+        coalesce_mouse_motion = enabled;
+        return true;
+
+    case SDL_EVENT_MOUSE_WHEEL:
+        coalesce_mouse_wheel = enabled;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool ion::sdl_events::is_coalesced(SDL_EventType type)
+{
+    switch (type)
+    {
+    case SDL_EVENT_MOUSE_MOTION:
+        return coalesce_mouse_motion;
+
+    case SDL_EVENT_MOUSE_WHEEL:
+        return coalesce_mouse_wheel;
+
+    default:
+        return false;
+    }
+}
+
+void ion::sdl_events::filter_unobserved(bool enabled)
+{
+    filter_unobserved_events = enabled;
+    refresh_event_filter();
+}
+
+bool ion::sdl_events::filters_unobserved()
+{
+    return filter_unobserved_events;
+}
+
+void ion::sdl_events::observe(SDL_EventType type, bool observed)
+{
+    const auto position = std::ranges::lower_bound(observed_without_sink, type);
+    const bool was_observed = position != observed_without_sink.end() and *position == type;
+    if (observed == was_observed) { return; }
+    if (observed) { observed_without_sink.insert(position, type); }
+    else { observed_without_sink.erase(position); }
+
+    // the filter only changes when the sinks do, so it has to be applied again
+    if (applied_event_filter) { apply_event_filter(*applied_event_filter); }
+}
+
+bool ion::sdl_events::is_observed(SDL_EventType type)
+{
+    return std::ranges::binary_search(observed_without_sink, type);
+}
+
+void ion::sdl_events::refresh_event_filter()
+{
+    // when filtering is off, every type is observed - which sdl will already be doing
+    // unless a filter was applied before
+    observed_events observed;
+    if (filter_unobserved_events)
+    {
+        const bool any_key_listeners = not key_batch_signal.empty();
+        const bool any_button_listeners = not mouse_button_batch_signal.empty();
+        observed = {
+            .everything = not poll_signal.empty() or not event_batch_signal.empty(),
+            .mouse_motion = not mouse_moved_signal.empty() or not mouse_motion_signal.empty()
+                            or not mouse_moved_batch_signal.empty(),
+            .mouse_button_down = any_button_listeners,
+            .mouse_button_up = any_button_listeners or not mouse_up_signal.empty(),
+            .mouse_wheel = not mouse_scroll_signal.empty() or not mouse_scroll_batch_signal.empty(),
+            .key_down = any_key_listeners or not key_down_signal.empty(),
+            .key_up = any_key_listeners or not key_up_signal.empty(),
+        };
+    }
+    else if (not applied_event_filter)
+    {
+        return;
+    }
+    if (applied_event_filter != observed)
+    {
+        apply_event_filter(observed);
+    }
+}
+
+void ion::sdl_events::flush()
+{
+    SDL_FlushEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST);
+}
+
+void ion::sdl_events::publish(event_buffers & buffers)
+{
+    for (const auto & event : buffers.events)
     {
-        poll_signal.publish(&event);
+        switch (event.type)
+        {
+        case SDL_EVENT_MOUSE_WHEEL:
+            buffers.mouse_wheel.push_back(event.wheel);
+            break;
+
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            buffers.mouse_button.push_back(event.button);
+            break;
+
+        case SDL_EVENT_MOUSE_MOTION:
+            buffers.mouse_motion.push_back(event.motion);
+            break;
+
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            buffers.key.push_back(event.key);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (not buffers.events.empty())
+    {
+        event_batch_signal.publish(std::span<const SDL_Event>{ buffers.events });
+    }
+    if (not buffers.mouse_motion.empty())
+    {
+        mouse_moved_batch_signal.publish(std::span<const SDL_MouseMotionEvent>{ buffers.mouse_motion });
+    }
+    if (not buffers.mouse_wheel.empty())
+    {
+        mouse_scroll_batch_signal.publish(std::span<const SDL_MouseWheelEvent>{ buffers.mouse_wheel });
+    }
+    if (not buffers.mouse_button.empty())
+    {
+        mouse_button_batch_signal.publish(std::span<const SDL_MouseButtonEvent>{ buffers.mouse_button });
+    }
+    if (not buffers.key.empty())
+    {
+        key_batch_signal.publish(std::span<const SDL_KeyboardEvent>{ buffers.key });
+    }
+
+    // the per-event sinks get every event in queue order, and a coalesced event takes the
+    // place of the last of the events it was merged from
+    std::size_t motions_left = buffers.mouse_motion.size();
+    std::size_t wheels_left = buffers.mouse_wheel.size();
+    for (const auto & event : buffers.events)
+    {
+        // the raw listeners may change the event, so they get a copy of it
+        SDL_Event raw_event = event;
+        poll_signal.publish(&raw_event);
+
         switch (event.type)
         {
         case SDL_EVENT_QUIT:
@@ -22,27 +352,38 @@ void ion::sdl_events::poll()
             break;
 
         case SDL_EVENT_MOUSE_WHEEL:
-            mouse_scroll_signal.publish(event.wheel.y);
+        {
+            --wheels_left;
+            if (coalesce_mouse_wheel and wheels_left > 0) { break; }
+            const auto & wheel = coalesce_mouse_wheel? coalesced(buffers.mouse_wheel) : event.wheel;
+            mouse_scroll_signal.publish(static_cast<int>(wheel.y));
             break;
-
+        }
         case SDL_EVENT_MOUSE_BUTTON_UP:
             mouse_up_signal.publish();
             break;
 
         case SDL_EVENT_MOUSE_MOTION:
-            mouse_moved_signal.publish(event.motion.x, event.motion.y);
+        {
+            --motions_left;
+            if (coalesce_mouse_motion and motions_left > 0) { break; }
+            const auto & motion = coalesce_mouse_motion? coalesced(buffers.mouse_motion) : event.motion;
+            mouse_motion_signal.publish(motion);
+            mouse_moved_signal.publish(static_cast<int>(motion.x), static_cast<int>(motion.y));
+            break;
+        }
+        case SDL_EVENT_KEY_DOWN:
+            key_down_signal.publish(event.key.key);
             break;
 
         case SDL_EVENT_KEY_UP:
             key_up_signal.publish(event.key.key);
             break;
 
-        case SDL_EVENT_KEY_DOWN:
-            key_down_signal.publish(event.key.key);
-            break;
-
         default:
             break;
         }
     }
-}
\ No newline at end of file
+    polled_signal.publish();
+    dispatch_profiler::end_poll();
+}
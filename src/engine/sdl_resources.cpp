@@ -1,6 +1,6 @@
 #include "ion/engine/sdl_resources.hpp"
 
-#include <SDl3/SDL_init.h>
+#include <SDL3/SDL_init.h>
 #include <SDL3/SDL_video.h>
 #include <SDL3/SDL_render.h>
 #include <SDL3/SDL_surface.h>
@@ -30,6 +30,11 @@ void ion::internal::sdl_deleter::operator()(SDL_Surface * surface) const
     if (surface) { SDL_DestroySurface(surface); }
 }
 
+void ion::internal::sdl_deleter::operator()(SDL_Texture * texture) const
+{
+    if (texture) { SDL_DestroyTexture(texture); }
+}
+
 ion::sdl_system ion::init_sdl(std::uint32_t init_flags)
 {
     return sdl_system(new internal::sdl_system(init_flags), {});
@@ -49,3 +54,8 @@ ion::sdl_surface ion::load_bitmap(std::string_view path)
 {
     return { SDL_LoadBMP(path.data()), {} };
 }
+
+ion::sdl_texture ion::create_texture(SDL_Renderer * renderer, SDL_Surface * surface)
+{
+    return { SDL_CreateTextureFromSurface(renderer, surface), {} };
+}
\ No newline at end of file
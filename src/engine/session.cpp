@@ -0,0 +1,329 @@
+#include "ion/engine/session.hpp"
+#include "ion/engine/sdl_events.hpp"
+
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_keyboard.h>
+#include <SDL3/SDL_log.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+// a recording is the magic and version followed by a stream of records, each starting with
+// its kind. Seeds hold a 32-bit seed. Held input holds the 32-bit mouse button flags, the
+// mouse position as two 32-bit floats and a 16-bit key count, followed by each key as a
+// 16-bit scancode. Frames hold a 64-bit floating point delta time and a 32-bit event count,
+// followed by each event as its 32-bit type, its 16-bit payload size, and then the payload
+constexpr std::array<char, 4> recording_magic{ 'i', 'o', 'n', 'r' };
+constexpr std::uint32_t recording_version = 2;
+
+enum class record_kind : std::uint8_t { seed = 'S', input = 'I', frame = 'F' };
+
+std::ofstream recording;
+std::ifstream playback;
+
+// the events consumed during the frame that's being recorded
+std::vector<SDL_Event> frame_events;
+
+// records that were asked for while the frame was being polled, which are written after it
+std::string deferred_records;
+bool is_polling_frame = false;
+
+template<typename T>
+void write(const T & value)
+{
+    if (is_polling_frame)
+    {
+        deferred_records.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        return;
+    }
+    recording.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read(T & value)
+{
+    return static_cast<bool>(playback.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+/**
+ * The number of bytes of an event that are worth recording
+ *
+ * Events that point to memory owned by sdl or that belong to devices that may not exist
+ * when replaying aren't recorded at all.
+ */
+std::uint16_t payload_size(Uint32 type)
+{
+    if (type >= SDL_EVENT_WINDOW_FIRST and type <= SDL_EVENT_WINDOW_LAST)
+    {
+        return sizeof(SDL_WindowEvent);
+    }
+    switch (type)
+    {
+    case SDL_EVENT_QUIT:
+        return sizeof(SDL_QuitEvent);
+
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        return sizeof(SDL_KeyboardEvent);
+
+    case SDL_EVENT_MOUSE_MOTION:
+        return sizeof(SDL_MouseMotionEvent);
+
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        return sizeof(SDL_MouseButtonEvent);
+
+    case SDL_EVENT_MOUSE_WHEEL:
+        return sizeof(SDL_MouseWheelEvent);
+
+    default:
+        return 0;
+    }
+}
+
+void record_events(std::span<const SDL_Event> events)
+{
+    std::ranges::copy_if(events, std::back_inserter(frame_events),
+                         [](const SDL_Event & event) { return payload_size(event.type) > 0; });
+}
+
+void write_frame(double dt)
+{
+    write(record_kind::frame);
+    write(dt);
+    write(static_cast<std::uint32_t>(frame_events.size()));
+    for (const auto & event : frame_events)
+    {
+        const std::uint16_t size = payload_size(event.type);
+        write(event.type);
+        write(size);
+        recording.write(reinterpret_cast<const char *>(&event), size);
+    }
+    frame_events.clear();
+
+    recording.write(deferred_records.data(), static_cast<std::streamsize>(deferred_records.size()));
+    deferred_records.clear();
+}
+
+bool read_kind(record_kind expected)
+{
+    record_kind kind;
+    if (not read(kind)) { return false; }
+    if (kind != expected)
+    {
+        SDL_Log("Stopping replay because the recording doesn't match the program: "
+                "expected a '%c' record but found '%c'\n",
+                static_cast<char>(expected), static_cast<char>(kind));
+        return false;
+    }
+    return true;
+}
+
+bool read_frame(double & dt)
+{
+    std::uint32_t num_events = 0;
+    if (not read_kind(record_kind::frame) or not read(dt) or not read(num_events))
+    {
+        return false;
+    }
+    frame_events.clear();
+    for (std::uint32_t k = 0; k < num_events; ++k)
+    {
+        Uint32 type;
+        std::uint16_t size;
+        if (not read(type) or not read(size) or size > sizeof(SDL_Event)) { return false; }
+
+        SDL_Event event;
+        std::memset(&event, 0, sizeof(SDL_Event));
+        if (not playback.read(reinterpret_cast<char *>(&event), size)) { return false; }
+        frame_events.push_back(event);
+    }
+    return true;
+}
+
+void end_replay()
+{
+    ion::session::stop();
+
+    // let the program wind down the same way it would if the user had quit
+    SDL_Event quit;
+    std::memset(&quit, 0, sizeof(SDL_Event));
+    quit.type = SDL_EVENT_QUIT;
+    ion::sdl_events::dispatch({ &quit, 1 });
+}
+}
+
+bool ion::session::record(std::string_view path)
+{
+    stop();
+    recording.open(std::string{ path }, std::ios::binary | std::ios::trunc);
+    if (not recording)
+    {
+        SDL_Log("Couldn't record the session because %.*s couldn't be opened\n",
+                static_cast<int>(path.size()), path.data());
+        return false;
+    }
+    recording.write(recording_magic.data(), recording_magic.size());
+    write(recording_version);
+    sdl_events::on_event_batch().connect<&record_events>();
+    return true;
+}
+
+bool ion::session::replay(std::string_view path)
+{
+    stop();
+    playback.open(std::string{ path }, std::ios::binary);
+    if (not playback)
+    {
+        SDL_Log("Couldn't replay the session because %.*s couldn't be opened\n",
+                static_cast<int>(path.size()), path.data());
+        return false;
+    }
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    playback.read(magic.data(), magic.size());
+    if (not read(version) or magic != recording_magic or version != recording_version)
+    {
+        SDL_Log("Couldn't replay the session because %.*s isn't a version %u recording\n",
+                static_cast<int>(path.size()), path.data(), recording_version);
+        playback.close();
+        return false;
+    }
+    return true;
+}
+
+bool ion::session::from_args(int argc, char * argv[])
+{
+    using namespace std::string_view_literals;
+    for (int k = 1; k + 1 < argc; ++k)
+    {
+        if (argv[k] == "--record"sv) { return record(argv[k + 1]); }
+        if (argv[k] == "--replay"sv) { return replay(argv[k + 1]); }
+    }
+    return true;
+}
+
+void ion::session::stop()
+{
+    if (recording.is_open())
+    {
+        sdl_events::on_event_batch().disconnect<&record_events>();
+        recording.close();
+    }
+    if (playback.is_open())
+    {
+        playback.close();
+    }
+    frame_events.clear();
+    deferred_records.clear();
+}
+
+bool ion::session::is_recording()
+{
+    return recording.is_open();
+}
+
+bool ion::session::is_replaying()
+{
+    return playback.is_open();
+}
+
+std::uint32_t ion::session::seed()
+{
+    if (is_replaying())
+    {
+        std::uint32_t seed = 0;
+        if (read_kind(record_kind::seed) and read(seed)) { return seed; }
+        end_replay();
+    }
+    const std::uint32_t seed = std::random_device{}();
+    if (is_recording())
+    {
+        write(record_kind::seed);
+        write(seed);
+    }
+    return seed;
+}
+
+ion::session::held_input ion::session::input()
+{
+    held_input held;
+    if (is_replaying())
+    {
+        std::uint16_t num_keys = 0;
+        if (read_kind(record_kind::input) and read(held.buttons) and read(held.mouse.x)
+                                          and read(held.mouse.y) and read(num_keys))
+        {
+            std::uint16_t key = 0;
+            for (std::uint16_t k = 0; k < num_keys and read(key); ++k)
+            {
+                held.keys.push_back(static_cast<SDL_Scancode>(key));
+            }
+            if (held.keys.size() == num_keys) { return held; }
+        }
+        end_replay();
+        return {};
+    }
+
+    int num_states = 0;
+    const bool * is_held = SDL_GetKeyboardState(&num_states);
+    for (int key = 0; is_held and key < num_states; ++key)
+    {
+        if (is_held[key]) { held.keys.push_back(static_cast<SDL_Scancode>(key)); }
+    }
+    held.buttons = SDL_GetMouseState(&held.mouse.x, &held.mouse.y);
+
+    if (is_recording())
+    {
+        write(record_kind::input);
+        write(held.buttons);
+        write(held.mouse.x);
+        write(held.mouse.y);
+        write(static_cast<std::uint16_t>(held.keys.size()));
+        for (const SDL_Scancode key : held.keys)
+        {
+            write(static_cast<std::uint16_t>(key));
+        }
+    }
+    return held;
+}
+
+float ion::session::poll(float measured_dt)
+{
+    if (not is_replaying())
+    {
+        // what listeners ask for is replayed after the frame is read, so it's written after it
+        is_polling_frame = is_recording();
+        sdl_events::poll();
+        is_polling_frame = false;
+        if (is_recording())
+        {
+            write_frame(measured_dt);
+        }
+        return measured_dt;
+    }
+
+    // keep the window responsive, but throw away live input other than quitting
+    SDL_PumpEvents();
+    SDL_Event quit;
+    const bool wants_to_quit = SDL_PeepEvents(&quit, 1, SDL_GETEVENT, SDL_EVENT_QUIT, SDL_EVENT_QUIT) > 0;
+    sdl_events::flush();
+
+    double dt = 0.;
+    if (wants_to_quit or not read_frame(dt))
+    {
+        end_replay();
+        return 0.f;
+    }
+    sdl_events::dispatch(frame_events);
+    return static_cast<float>(dt);
+}
@@ -0,0 +1,203 @@
+#include "ion/engine/soft_raster.hpp"
+#include "ion/engine/tint_blit.hpp"
+
+#include <SDL3/SDL_surface.h>
+
+#include <algorithm>
+
+std::size_t ion::soft_raster::default_num_workers()
+{
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1) - 1;
+}
+
+ion::soft_raster::soft_raster(std::size_t num_workers, int bin_size)
+    : bin_size{ std::max(bin_size, 8) }
+{
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i)
+    {
+        workers.emplace_back([this](std::stop_token stop) { run_frames(stop); });
+    }
+}
+
+ion::soft_raster::~soft_raster()
+{
+    for (auto & worker : workers) { worker.request_stop(); }
+    frame_started.notify_all();
+    workers.clear();
+}
+
+bool ion::soft_raster::begin(SDL_Surface * surface)
+{
+    discard();
+    if (not surface or not surface->pixels or SDL_MUSTLOCK(surface)) { return false; }
+
+    const auto * format = SDL_GetPixelFormatDetails(surface->format);
+    if (not format or format->bytes_per_pixel != 4) { return false; }
+
+    target = surface;
+    target_format = format;
+    clip_rect = SDL_Rect{ 0, 0, surface->w, surface->h };
+    bins_wide = (surface->w + bin_size - 1)/bin_size;
+    bins_high = (surface->h + bin_size - 1)/bin_size;
+
+    // keep each bin's list around between frames so recording doesn't allocate
+    bin_commands.resize(static_cast<std::size_t>(bins_wide)*bins_high);
+    return true;
+}
+
+void ion::soft_raster::clip(const SDL_Rect * rect)
+{
+    if (not target) { return; }
+    const SDL_Rect bounds{ 0, 0, target->w, target->h };
+    if (not rect) { clip_rect = bounds; }
+    else if (not SDL_GetRectIntersection(rect, &bounds, &clip_rect)) { clip_rect = SDL_Rect{ 0, 0, 0, 0 }; }
+}
+
+void ion::soft_raster::fill(const SDL_Rect & rect, const SDL_Color & color)
+{
+    if (not target) { return; }
+    command cmd{};
+    cmd.kind = command_kind::fill;
+    cmd.rect = rect;
+    cmd.mapped_fill = SDL_MapRGBA(target_format, nullptr, color.r, color.g, color.b, 0xff);
+    record(cmd);
+}
+
+bool ion::soft_raster::tint_blit(SDL_Surface * source, const SDL_Rect & rect,
+                                 const SDL_Color & fill, const SDL_Color & modulate)
+{
+    if (not target or not can_tint_blit(source, target) or SDL_MUSTLOCK(source) or
+        source->w != rect.w or source->h != rect.h)
+    {
+        return false;
+    }
+    command cmd{};
+    cmd.kind = command_kind::tint_blit;
+    cmd.rect = rect;
+    cmd.fill = fill;
+    cmd.modulate = modulate;
+    cmd.source = source;
+    record(cmd);
+    return true;
+}
+
+void ion::soft_raster::record(const command & cmd)
+{
+    SDL_Rect area;
+    if (not SDL_GetRectIntersection(&cmd.rect, &clip_rect, &area)) { return; }
+
+    const auto index = static_cast<std::uint32_t>(commands.size());
+    commands.push_back(cmd);
+    commands.back().clip = area;
+
+    const int first_x = area.x/bin_size;
+    const int first_y = area.y/bin_size;
+    const int last_x = (area.x + area.w - 1)/bin_size;
+    const int last_y = (area.y + area.h - 1)/bin_size;
+    for (int y = first_y; y <= last_y; ++y)
+    {
+        for (int x = first_x; x <= last_x; ++x)
+        {
+            bin_commands[static_cast<std::size_t>(y)*bins_wide + x].push_back(index);
+        }
+    }
+}
+
+void ion::soft_raster::end()
+{
+    if (not target) { return; }
+
+    active_bins.clear();
+    for (std::size_t bin = 0; bin < bin_commands.size(); ++bin)
+    {
+        if (not bin_commands[bin].empty()) { active_bins.push_back(bin); }
+    }
+
+    // waking the workers costs more than a single bin takes to draw
+    next_bin.store(0, std::memory_order_relaxed);
+    if (workers.empty() or active_bins.size() < 2)
+    {
+        rasterize_bins();
+    }
+    else
+    {
+        {
+            std::scoped_lock lock{ frame_mutex };
+            ++frame;
+            num_busy = workers.size();
+        }
+        frame_started.notify_all();
+        rasterize_bins();
+
+        std::unique_lock lock{ frame_mutex };
+        frame_finished.wait(lock, [this] { return num_busy == 0; });
+    }
+    discard();
+}
+
+void ion::soft_raster::discard()
+{
+    commands.clear();
+    for (auto & indices : bin_commands) { indices.clear(); }
+    active_bins.clear();
+    target = nullptr;
+    target_format = nullptr;
+}
+
+void ion::soft_raster::run_frames(std::stop_token stop)
+{
+    std::uint64_t last_frame = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock{ frame_mutex };
+            if (not frame_started.wait(lock, stop, [&] { return frame != last_frame; })) { return; }
+            last_frame = frame;
+        }
+        rasterize_bins();
+        {
+            std::scoped_lock lock{ frame_mutex };
+            --num_busy;
+        }
+        frame_finished.notify_one();
+    }
+}
+
+void ion::soft_raster::rasterize_bins()
+{
+    for (std::size_t i = next_bin.fetch_add(1, std::memory_order_relaxed); i < active_bins.size();
+         i = next_bin.fetch_add(1, std::memory_order_relaxed))
+    {
+        rasterize(active_bins[i]);
+    }
+}
+
+void ion::soft_raster::rasterize(std::size_t bin) const
+{
+    const int x = static_cast<int>(bin % bins_wide)*bin_size;
+    const int y = static_cast<int>(bin / bins_wide)*bin_size;
+    const SDL_Rect bounds{ x, y, std::min(bin_size, target->w - x), std::min(bin_size, target->h - y) };
+
+    auto * pixels = static_cast<std::uint8_t *>(target->pixels);
+    for (const std::uint32_t index : bin_commands[bin])
+    {
+        const command & cmd = commands[index];
+        SDL_Rect area;
+        if (not SDL_GetRectIntersection(&cmd.clip, &bounds, &area)) { continue; }
+
+        switch (cmd.kind)
+        {
+        case command_kind::fill:
+            for (int row = area.y; row < area.y + area.h; ++row)
+            {
+                auto * first = reinterpret_cast<std::uint32_t *>(pixels + row*target->pitch) + area.x;
+                std::fill_n(first, area.w, cmd.mapped_fill);
+            }
+            break;
+        case command_kind::tint_blit:
+            ion::tint_blit(cmd.source, target, cmd.rect, area, cmd.fill, cmd.modulate);
+            break;
+        }
+    }
+}
\ No newline at end of file
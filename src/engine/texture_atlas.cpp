@@ -0,0 +1,233 @@
+#include "ion/engine/texture_atlas.hpp"
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_render.h>
+#include <SDL3/SDL_surface.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <optional>
+
+namespace
+{
+// the white block is a few texels wide so that sampling its center never reaches the padding
+constexpr int white_block_size = 4;
+
+struct skyline_node
+{
+    int x, y, width;
+};
+
+/** A skyline bottom-left packer for a fixed size bin */
+class skyline_packer
+{
+public:
+    skyline_packer(int width, int height)
+        : width{ width }, height{ height }, skyline{ { 0, 0, width } }
+    {
+    }
+
+    std::optional<SDL_Point> insert(int w, int h)
+    {
+        // find the node where the rect sits lowest, breaking ties by the narrowest node
+        std::size_t best_index = skyline.size();
+        int best_y = std::numeric_limits<int>::max();
+        int best_width = std::numeric_limits<int>::max();
+        for (std::size_t i = 0; i < skyline.size(); ++i)
+        {
+            const auto y = fit(i, w, h);
+            if (not y) { continue; }
+            if (*y < best_y or (*y == best_y and skyline[i].width < best_width))
+            {
+                best_index = i;
+                best_y = *y;
+                best_width = skyline[i].width;
+            }
+        }
+        if (best_index == skyline.size()) { return std::nullopt; }
+
+        const SDL_Point position{ skyline[best_index].x, best_y };
+        add_level(best_index, position.x, position.y + h, w);
+        return position;
+    }
+private:
+    /** The height a rect would sit at if placed at a node, or nothing if it doesn't fit */
+    std::optional<int> fit(std::size_t index, int w, int h) const
+    {
+        const int x = skyline[index].x;
+        if (x + w > width) { return std::nullopt; }
+
+        int y = 0;
+        for (int remaining = w; remaining > 0; ++index)
+        {
+            y = std::max(y, skyline[index].y);
+            if (y + h > height) { return std::nullopt; }
+            remaining -= skyline[index].width;
+        }
+        return y;
+    }
+
+    void add_level(std::size_t index, int x, int y, int w)
+    {
+        skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index), skyline_node{ x, y, w });
+
+        // shrink or remove the nodes that the new level covers
+        for (std::size_t i = index + 1; i < skyline.size();)
+        {
+            auto & node = skyline[i];
+            const int covered = x + w - node.x;
+            if (covered <= 0) { break; }
+            if (covered < node.width)
+            {
+                node.x += covered;
+                node.width -= covered;
+                break;
+            }
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        // merge neighbours at the same height
+        for (std::size_t i = 0; i + 1 < skyline.size();)
+        {
+            if (skyline[i].y == skyline[i + 1].y)
+            {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            }
+            else { ++i; }
+        }
+    }
+
+    int width, height;
+    std::vector<skyline_node> skyline;
+};
+
+struct packed_image
+{
+    std::uint32_t id;
+    SDL_Surface * surface;
+    SDL_Rect bounds;
+};
+
+/** Pack every image into a square bin, or return nothing if they don't fit */
+std::optional<std::vector<packed_image>> pack(std::vector<packed_image> images, int size, int padding)
+{
+    skyline_packer packer{ size, size };
+    for (auto & image : images)
+    {
+        const int w = image.bounds.w + padding;
+        const int h = image.bounds.h + padding;
+        const auto position = packer.insert(w, h);
+        if (not position) { return std::nullopt; }
+        image.bounds.x = position->x;
+        image.bounds.y = position->y;
+    }
+    return images;
+}
+
+SDL_FRect normalized(const SDL_Rect & bounds, int size)
+{
+    const float scale = 1.f/static_cast<float>(size);
+    return { static_cast<float>(bounds.x)*scale, static_cast<float>(bounds.y)*scale,
+             static_cast<float>(bounds.w)*scale, static_cast<float>(bounds.h)*scale };
+}
+}
+
+const SDL_FRect * ion::texture_atlas::uv_for(std::uint32_t id) const
+{
+    if (const auto search = uvs.find(id); search != uvs.end())
+    {
+        return &search->second;
+    }
+    return nullptr;
+}
+
+ion::atlas_builder::atlas_builder(int max_size, int padding)
+    : max_size{ max_size }, padding{ std::max(padding, 0) }
+{
+}
+
+void ion::atlas_builder::add(std::uint32_t id, SDL_Surface * surface)
+{
+    if (surface) { images.emplace_back(id, surface); }
+}
+
+ion::texture_atlas ion::atlas_builder::build(SDL_Renderer * renderer) const
+{
+    // the white block is packed like any other image, with a null surface
+    std::vector<packed_image> unpacked;
+    unpacked.reserve(images.size() + 1);
+    unpacked.push_back({ 0, nullptr, { 0, 0, white_block_size, white_block_size } });
+    for (const auto & [id, surface] : images)
+    {
+        unpacked.push_back({ id, surface, { 0, 0, surface->w, surface->h } });
+    }
+    std::ranges::stable_sort(unpacked, std::ranges::greater{},
+                             [](const packed_image & image) { return image.bounds.h; });
+
+    // start from the smallest square that could hold every image, and grow until they fit
+    const int area = std::accumulate(unpacked.begin(), unpacked.end(), 0, [this](int sum, const packed_image & image)
+    {
+        return sum + (image.bounds.w + padding)*(image.bounds.h + padding);
+    });
+    const auto min_side = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<double>(area))));
+    int size = static_cast<int>(std::bit_ceil(min_side));
+    std::optional<std::vector<packed_image>> packed;
+    for (; size <= max_size and not packed; size *= 2)
+    {
+        packed = pack(unpacked, size, padding);
+    }
+    size /= 2;
+    if (not packed)
+    {
+        SDL_Log("Couldn't pack %zu images into a %dx%d atlas\n", images.size(), max_size, max_size);
+        return texture_atlas{};
+    }
+
+    sdl_surface canvas{ SDL_CreateSurface(size, size, SDL_PIXELFORMAT_RGBA32), {} };
+    if (not canvas)
+    {
+        SDL_Log("Couldn't create an atlas surface: %s\n", SDL_GetError());
+        return texture_atlas{};
+    }
+    SDL_FillSurfaceRect(canvas.get(), nullptr, SDL_MapSurfaceRGBA(canvas.get(), 0, 0, 0, 0));
+
+    texture_atlas atlas;
+    for (const auto & image : *packed)
+    {
+        if (not image.surface)
+        {
+            SDL_FillSurfaceRect(canvas.get(), &image.bounds, SDL_MapSurfaceRGBA(canvas.get(), 0xff, 0xff, 0xff, 0xff));
+
+            // every corner samples the center of the block
+            const SDL_FPoint center{ static_cast<float>(image.bounds.x) + white_block_size/2.f,
+                                     static_cast<float>(image.bounds.y) + white_block_size/2.f };
+            atlas.white = { center.x/static_cast<float>(size), center.y/static_cast<float>(size), 0.f, 0.f };
+            continue;
+        }
+        // copy the image as is, alpha included, rather than blending it onto the canvas
+        SDL_BlendMode blend_mode;
+        SDL_GetSurfaceBlendMode(image.surface, &blend_mode);
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        SDL_Rect bounds = image.bounds;
+        SDL_BlitSurface(image.surface, nullptr, canvas.get(), &bounds);
+        SDL_SetSurfaceBlendMode(image.surface, blend_mode);
+
+        atlas.uvs.try_emplace(image.id, normalized(image.bounds, size));
+    }
+
+    atlas.atlas_texture = create_texture(renderer, canvas.get());
+    if (not atlas.atlas_texture)
+    {
+        SDL_Log("Couldn't upload the atlas: %s\n", SDL_GetError());
+        return texture_atlas{};
+    }
+    // neighbouring images are only a texel of padding apart, so sample without filtering
+    SDL_SetTextureScaleMode(atlas.atlas_texture.get(), SDL_SCALEMODE_NEAREST);
+    SDL_SetTextureBlendMode(atlas.atlas_texture.get(), SDL_BLENDMODE_BLEND);
+    atlas.atlas_width = size;
+    atlas.atlas_height = size;
+    return atlas;
+}
@@ -0,0 +1,49 @@
+#include "ion/engine/tilemap_renderer.hpp"
+#include "ion/engine/quad_geometry.hpp"
+
+ion::tilemap_renderer::tilemap_renderer(std::size_t num_layers)
+    : layers(num_layers)
+{
+}
+
+void ion::tilemap_renderer::clear()
+{
+    for (auto & layer : layers)
+    {
+        layer.vertices.clear();
+        layer.indices.clear();
+    }
+}
+
+void ion::tilemap_renderer::fill(std::size_t layer, const SDL_FRect & dst, const SDL_Color & color)
+{
+    if (layer >= layers.size()) { return; }
+
+    // without an atlas the layer is drawn untextured, so the texture coordinates don't matter
+    const SDL_FRect uv = tile_atlas? tile_atlas->white_uv() : SDL_FRect{ 0.f, 0.f, 0.f, 0.f };
+    auto & [vertices, indices] = layers[layer];
+    push_quad(vertices, indices, dst, uv, to_fcolor(color));
+}
+
+void ion::tilemap_renderer::draw(std::size_t layer, std::uint32_t tile, const SDL_FRect & dst,
+                                 const SDL_Color & tint)
+{
+    if (layer >= layers.size() or not tile_atlas) { return; }
+
+    const SDL_FRect * uv = tile_atlas->uv_for(tile);
+    if (not uv) { return; }
+    auto & [vertices, indices] = layers[layer];
+    push_quad(vertices, indices, dst, *uv, to_fcolor(tint));
+}
+
+void ion::tilemap_renderer::render(SDL_Renderer * renderer) const
+{
+    SDL_Texture * texture = tile_atlas? tile_atlas->texture() : nullptr;
+    for (const auto & [vertices, indices] : layers)
+    {
+        if (indices.empty()) { continue; }
+        SDL_RenderGeometry(renderer, texture,
+                           vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size()));
+    }
+}
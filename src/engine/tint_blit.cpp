@@ -0,0 +1,360 @@
+#include "ion/engine/tint_blit.hpp"
+
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_surface.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ION_TINT_BLIT_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ION_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ION_TARGET(isa)
+#endif
+
+namespace
+{
+/** Everything a kernel needs to blend one row, with each channel kept in its byte lane */
+struct blit_row
+{
+    const std::uint32_t * source;
+    std::uint32_t * destination;
+    int width;
+
+    std::uint32_t fill;            // the fill color in the destination format
+    std::uint32_t modulate;        // the modulation per lane, alpha in the alpha lane
+    std::uint32_t opaque_bits;     // set in the alpha lane when the source has no alpha
+    int alpha_shift;               // the position of the alpha lane
+    std::uint32_t unused_mask;     // the destination lane that keeps the fill's value
+    bool has_color_key;
+    std::uint32_t color_key;       // compared against the source without its alpha lane
+    std::uint32_t color_key_mask;
+};
+
+/** sdl's x*y/255 */
+constexpr std::uint32_t mult_div_255(std::uint32_t x, std::uint32_t y)
+{
+    std::uint32_t product = x*y + 1;
+    product += product >> 8;
+    return (product >> 8) & 0xff;
+}
+
+/** sdl's blend of a source channel over a destination channel */
+constexpr std::uint32_t blend_channel(std::uint32_t source, std::uint32_t destination, std::uint32_t alpha)
+{
+    std::uint32_t blended = source*alpha + destination*(255 - alpha) + 1;
+    blended += blended >> 8;
+    return (blended >> 8) & 0xff;
+}
+
+void blend_scalar(const blit_row & row, int first)
+{
+    for (int x = first; x < row.width; ++x)
+    {
+        const std::uint32_t raw = row.source[x];
+        if (row.has_color_key and (raw & row.color_key_mask) == row.color_key)
+        {
+            row.destination[x] = row.fill;
+            continue;
+        }
+        const std::uint32_t pixel = raw | row.opaque_bits;
+
+        std::uint32_t modulated = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            modulated |= mult_div_255((pixel >> shift) & 0xff, (row.modulate >> shift) & 0xff) << shift;
+        }
+        const std::uint32_t alpha = (modulated >> row.alpha_shift) & 0xff;
+
+        std::uint32_t blended = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            blended |= blend_channel((modulated >> shift) & 0xff, (row.fill >> shift) & 0xff, alpha) << shift;
+        }
+        row.destination[x] = (blended & ~row.unused_mask) | (row.fill & row.unused_mask);
+    }
+}
+
+#ifdef ION_TINT_BLIT_X86
+ION_TARGET("sse2")
+__m128i mult_div_255_sse2(__m128i x, __m128i y)
+{
+    __m128i product = _mm_add_epi16(_mm_mullo_epi16(x, y), _mm_set1_epi16(1));
+    product = _mm_add_epi16(product, _mm_srli_epi16(product, 8));
+    return _mm_srli_epi16(product, 8);
+}
+
+ION_TARGET("sse2")
+__m128i blend_channels_sse2(__m128i source, __m128i destination, __m128i alpha)
+{
+    const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    __m128i blended = _mm_add_epi16(_mm_mullo_epi16(source, alpha), _mm_mullo_epi16(destination, inverse));
+    blended = _mm_add_epi16(blended, _mm_set1_epi16(1));
+    blended = _mm_add_epi16(blended, _mm_srli_epi16(blended, 8));
+    return _mm_srli_epi16(blended, 8);
+}
+
+ION_TARGET("sse2")
+void blend_sse2(const blit_row & row)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fill = _mm_set1_epi32(static_cast<int>(row.fill));
+    const __m128i fill_wide = _mm_unpacklo_epi8(fill, zero);
+    const __m128i modulate = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(row.modulate)), zero);
+    const __m128i opaque_bits = _mm_set1_epi32(static_cast<int>(row.opaque_bits));
+    const __m128i unused_mask = _mm_set1_epi32(static_cast<int>(row.unused_mask));
+    const __m128i color_key = _mm_set1_epi32(static_cast<int>(row.color_key));
+    const __m128i color_key_mask = _mm_set1_epi32(static_cast<int>(row.color_key_mask));
+    const __m128i alpha_shift = _mm_cvtsi32_si128(row.alpha_shift);
+    const __m128i low_byte = _mm_set1_epi32(0xff);
+
+    int x = 0;
+    for (; x + 4 <= row.width; x += 4)
+    {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row.source + x));
+        const __m128i pixels = _mm_or_si128(raw, opaque_bits);
+
+        // modulate every lane, alpha included, then spread each pixel's alpha to all four lanes
+        const __m128i low = mult_div_255_sse2(_mm_unpacklo_epi8(pixels, zero), modulate);
+        const __m128i high = mult_div_255_sse2(_mm_unpackhi_epi8(pixels, zero), modulate);
+        __m128i alpha = _mm_and_si128(_mm_srl_epi32(_mm_packus_epi16(low, high), alpha_shift), low_byte);
+        alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+        alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+
+        const __m128i blended_low = blend_channels_sse2(low, fill_wide, _mm_unpacklo_epi8(alpha, zero));
+        const __m128i blended_high = blend_channels_sse2(high, fill_wide, _mm_unpackhi_epi8(alpha, zero));
+        __m128i blended = _mm_packus_epi16(blended_low, blended_high);
+        blended = _mm_or_si128(_mm_andnot_si128(unused_mask, blended), _mm_and_si128(unused_mask, fill));
+
+        if (row.has_color_key)
+        {
+            const __m128i keyed = _mm_cmpeq_epi32(_mm_and_si128(raw, color_key_mask), color_key);
+            blended = _mm_or_si128(_mm_andnot_si128(keyed, blended), _mm_and_si128(keyed, fill));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(row.destination + x), blended);
+    }
+    blend_scalar(row, x);
+}
+
+ION_TARGET("avx2")
+__m256i mult_div_255_avx2(__m256i x, __m256i y)
+{
+    __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(x, y), _mm256_set1_epi16(1));
+    product = _mm256_add_epi16(product, _mm256_srli_epi16(product, 8));
+    return _mm256_srli_epi16(product, 8);
+}
+
+ION_TARGET("avx2")
+__m256i blend_channels_avx2(__m256i source, __m256i destination, __m256i alpha)
+{
+    const __m256i inverse = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+    __m256i blended = _mm256_add_epi16(_mm256_mullo_epi16(source, alpha), _mm256_mullo_epi16(destination, inverse));
+    blended = _mm256_add_epi16(blended, _mm256_set1_epi16(1));
+    blended = _mm256_add_epi16(blended, _mm256_srli_epi16(blended, 8));
+    return _mm256_srli_epi16(blended, 8);
+}
+
+ION_TARGET("avx2")
+void blend_avx2(const blit_row & row)
+{
+    // unpacking and packing both work within 128-bit halves, so pixels come back in order
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i fill = _mm256_set1_epi32(static_cast<int>(row.fill));
+    const __m256i fill_wide = _mm256_unpacklo_epi8(fill, zero);
+    const __m256i modulate = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(row.modulate)), zero);
+    const __m256i opaque_bits = _mm256_set1_epi32(static_cast<int>(row.opaque_bits));
+    const __m256i unused_mask = _mm256_set1_epi32(static_cast<int>(row.unused_mask));
+    const __m256i color_key = _mm256_set1_epi32(static_cast<int>(row.color_key));
+    const __m256i color_key_mask = _mm256_set1_epi32(static_cast<int>(row.color_key_mask));
+    const __m128i alpha_shift = _mm_cvtsi32_si128(row.alpha_shift);
+    const __m256i low_byte = _mm256_set1_epi32(0xff);
+
+    int x = 0;
+    for (; x + 8 <= row.width; x += 8)
+    {
+        const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row.source + x));
+        const __m256i pixels = _mm256_or_si256(raw, opaque_bits);
+
+        const __m256i low = mult_div_255_avx2(_mm256_unpacklo_epi8(pixels, zero), modulate);
+        const __m256i high = mult_div_255_avx2(_mm256_unpackhi_epi8(pixels, zero), modulate);
+        __m256i alpha = _mm256_and_si256(_mm256_srl_epi32(_mm256_packus_epi16(low, high), alpha_shift), low_byte);
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 8));
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+
+        const __m256i blended_low = blend_channels_avx2(low, fill_wide, _mm256_unpacklo_epi8(alpha, zero));
+        const __m256i blended_high = blend_channels_avx2(high, fill_wide, _mm256_unpackhi_epi8(alpha, zero));
+        __m256i blended = _mm256_packus_epi16(blended_low, blended_high);
+        blended = _mm256_blendv_epi8(blended, fill, unused_mask);
+
+        if (row.has_color_key)
+        {
+            const __m256i keyed = _mm256_cmpeq_epi32(_mm256_and_si256(raw, color_key_mask), color_key);
+            blended = _mm256_blendv_epi8(blended, fill, keyed);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(row.destination + x), blended);
+    }
+    blend_scalar(row, x);
+}
+#endif
+
+using row_kernel = void (*)(const blit_row &);
+
+void blend_scalar_row(const blit_row & row)
+{
+    blend_scalar(row, 0);
+}
+
+bool is_supported(ion::tint_blit_kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef ION_TINT_BLIT_X86
+    case ion::tint_blit_kernel::sse2: return SDL_HasSSE2();
+    case ion::tint_blit_kernel::avx2: return SDL_HasAVX2();
+#endif
+    case ion::tint_blit_kernel::automatic:
+    case ion::tint_blit_kernel::scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+ion::tint_blit_kernel resolve(ion::tint_blit_kernel kernel)
+{
+    if (kernel != ion::tint_blit_kernel::automatic) { return kernel; }
+    if (is_supported(ion::tint_blit_kernel::avx2)) { return ion::tint_blit_kernel::avx2; }
+    if (is_supported(ion::tint_blit_kernel::sse2)) { return ion::tint_blit_kernel::sse2; }
+    return ion::tint_blit_kernel::scalar;
+}
+
+row_kernel kernel_for(ion::tint_blit_kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef ION_TINT_BLIT_X86
+    case ion::tint_blit_kernel::sse2: return &blend_sse2;
+    case ion::tint_blit_kernel::avx2: return &blend_avx2;
+#endif
+    default: return &blend_scalar_row;
+    }
+}
+
+ion::tint_blit_kernel chosen_kernel = ion::tint_blit_kernel::automatic;
+// blits can run on several threads at once, so the kernel is picked atomically
+std::atomic<row_kernel> blend_row{ nullptr };
+
+/** The byte lane a mask covers, or -1 if it isn't a single byte lane */
+int lane_shift(std::uint32_t mask)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        if (mask == (0xffu << shift)) { return shift; }
+    }
+    return -1;
+}
+}
+
+bool ion::use_tint_blit_kernel(tint_blit_kernel kernel)
+{
+    if (not is_supported(kernel)) { return false; }
+    chosen_kernel = kernel;
+    blend_row.store(kernel_for(resolve(kernel)), std::memory_order_relaxed);
+    return true;
+}
+
+ion::tint_blit_kernel ion::current_tint_blit_kernel()
+{
+    return resolve(chosen_kernel);
+}
+
+bool ion::can_tint_blit(const SDL_Surface * source, const SDL_Surface * destination)
+{
+    if (not source or not destination) { return false; }
+
+    // both surfaces need the same 8-bit color lanes, and the source's alpha, if it has any,
+    // has to sit in the lane the destination doesn't use
+    const auto * from = SDL_GetPixelFormatDetails(source->format);
+    const auto * to = SDL_GetPixelFormatDetails(destination->format);
+    if (not from or not to or from->bytes_per_pixel != 4 or to->bytes_per_pixel != 4) { return false; }
+    if (from->Rmask != to->Rmask or from->Gmask != to->Gmask or from->Bmask != to->Bmask) { return false; }
+    if (lane_shift(from->Rmask) < 0 or lane_shift(from->Gmask) < 0 or lane_shift(from->Bmask) < 0) { return false; }
+
+    const std::uint32_t unused_mask = ~(to->Rmask | to->Gmask | to->Bmask);
+    return lane_shift(unused_mask) >= 0 and (from->Amask == 0 or from->Amask == unused_mask);
+}
+
+bool ion::tint_blit(SDL_Surface * source, SDL_Surface * destination, const SDL_Rect & rect,
+                    const SDL_Color & fill, const SDL_Color & modulate)
+{
+    if (not destination) { return false; }
+    SDL_Rect clip;
+    SDL_GetSurfaceClipRect(destination, &clip);
+    return tint_blit(source, destination, rect, clip, fill, modulate);
+}
+
+bool ion::tint_blit(SDL_Surface * source, SDL_Surface * destination, const SDL_Rect & rect,
+                    const SDL_Rect & clip, const SDL_Color & fill, const SDL_Color & modulate)
+{
+    if (not can_tint_blit(source, destination) or source->w != rect.w or source->h != rect.h) { return false; }
+
+    SDL_Rect area;
+    if (not SDL_GetRectIntersection(&rect, &clip, &area)) { return true; }
+
+    const auto * from = SDL_GetPixelFormatDetails(source->format);
+    const auto * to = SDL_GetPixelFormatDetails(destination->format);
+    const std::uint32_t unused_mask = ~(to->Rmask | to->Gmask | to->Bmask);
+    const int alpha_shift = lane_shift(unused_mask);
+
+    blit_row row{};
+    row.width = area.w;
+    row.fill = SDL_MapRGBA(to, nullptr, fill.r, fill.g, fill.b, 0xff);
+    row.modulate = (static_cast<std::uint32_t>(modulate.r) << lane_shift(to->Rmask))
+                 | (static_cast<std::uint32_t>(modulate.g) << lane_shift(to->Gmask))
+                 | (static_cast<std::uint32_t>(modulate.b) << lane_shift(to->Bmask))
+                 | (static_cast<std::uint32_t>(modulate.a) << alpha_shift);
+    row.opaque_bits = from->Amask != 0? 0u : unused_mask;
+    row.alpha_shift = alpha_shift;
+    row.unused_mask = unused_mask;
+    row.color_key_mask = ~from->Amask;
+    if (std::uint32_t key; SDL_GetSurfaceColorKey(source, &key))
+    {
+        row.has_color_key = true;
+        row.color_key = key & row.color_key_mask;
+    }
+    row_kernel blend = blend_row.load(std::memory_order_relaxed);
+    if (not blend)
+    {
+        blend = kernel_for(resolve(chosen_kernel));
+        blend_row.store(blend, std::memory_order_relaxed);
+    }
+
+    const bool lock_source = SDL_MUSTLOCK(source);
+    const bool lock_destination = SDL_MUSTLOCK(destination);
+    if (lock_source and not SDL_LockSurface(source)) { return false; }
+    if (lock_destination and not SDL_LockSurface(destination))
+    {
+        if (lock_source) { SDL_UnlockSurface(source); }
+        return false;
+    }
+    const auto * source_pixels = static_cast<const std::uint8_t *>(source->pixels);
+    auto * destination_pixels = static_cast<std::uint8_t *>(destination->pixels);
+    for (int y = 0; y < area.h; ++y)
+    {
+        const int source_y = area.y - rect.y + y;
+        row.source = reinterpret_cast<const std::uint32_t *>(source_pixels + source_y*source->pitch)
+                   + (area.x - rect.x);
+        row.destination = reinterpret_cast<std::uint32_t *>(destination_pixels + (area.y + y)*destination->pitch)
+                        + area.x;
+        blend(row);
+    }
+    if (lock_destination) { SDL_UnlockSurface(destination); }
+    if (lock_source) { SDL_UnlockSurface(source); }
+    return true;
+}
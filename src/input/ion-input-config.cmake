@@ -1,4 +1,5 @@
 include(CMakeFindDependencyMacro)
 find_dependency(SDL3)
+find_dependency(ion-engine)
 include("${CMAKE_CURRENT_LIST_DIR}/ion-input-targets.cmake")
 add_library(ion::input ALIAS ion::ion-input)
@@ -0,0 +1,132 @@
+#include "ion/input/snapshot.hpp"
+#include <ion/engine/sdl_events.hpp>
+#include <ion/engine/session.hpp>
+
+namespace {
+// the snapshot that's being built from this poll's events, and the one that was committed
+ion::input::snapshot pending;
+ion::input::snapshot committed;
+bool is_capturing_input = false;
+}
+
+namespace ion::input {
+
+void snapshot::capture()
+{
+    if (is_capturing_input) {
+        return;
+    }
+    is_capturing_input = true;
+
+    // start out with what's held, which the session records so replays start the same way
+    const auto held = session::input();
+    for (const SDL_Scancode key : held.keys) {
+        if (is_valid(key)) {
+            pending.keys[key] = true;
+        }
+    }
+    pending.buttons = held.buttons;
+    pending.mouse = held.mouse;
+    pending.previous_keys = pending.keys;
+    pending.previous_buttons = pending.buttons;
+    committed = pending;
+
+    sdl_events::on_key_batch().connect<&snapshot::on_keys>();
+    sdl_events::on_mouse_button_batch().connect<&snapshot::on_buttons>();
+    sdl_events::on_mouse_moved_batch().connect<&snapshot::on_motion>();
+    sdl_events::on_mouse_scroll_batch().connect<&snapshot::on_scroll>();
+    sdl_events::on_polled().connect<&snapshot::on_polled>();
+}
+
+void snapshot::stop_capturing()
+{
+    if (not is_capturing_input) {
+        return;
+    }
+    is_capturing_input = false;
+    sdl_events::on_key_batch().disconnect<&snapshot::on_keys>();
+    sdl_events::on_mouse_button_batch().disconnect<&snapshot::on_buttons>();
+    sdl_events::on_mouse_moved_batch().disconnect<&snapshot::on_motion>();
+    sdl_events::on_mouse_scroll_batch().disconnect<&snapshot::on_scroll>();
+    sdl_events::on_polled().disconnect<&snapshot::on_polled>();
+}
+
+bool snapshot::is_capturing()
+{
+    return is_capturing_input;
+}
+
+snapshot const & snapshot::current()
+{
+    return committed;
+}
+
+SDL_MouseButtonFlags snapshot::button_mask(std::uint8_t button)
+{
+    return button > 0 and button <= 32? SDL_BUTTON_MASK(button) : 0;
+}
+
+void snapshot::on_keys(std::span<const SDL_KeyboardEvent> events)
+{
+    for (auto const & event : events) {
+        if (not is_valid(event.scancode)) {
+            continue;
+        }
+        pending.keys[event.scancode] = event.down;
+        if (event.down and not event.repeat) {
+            pending.pressed_keys[event.scancode] = true;
+        }
+        if (not event.down) {
+            pending.released_keys[event.scancode] = true;
+        }
+    }
+}
+
+void snapshot::on_buttons(std::span<const SDL_MouseButtonEvent> events)
+{
+    for (auto const & event : events) {
+        const SDL_MouseButtonFlags mask = button_mask(event.button);
+        if (event.down) {
+            pending.buttons |= mask;
+            pending.pressed_buttons |= mask;
+        } else {
+            pending.buttons &= ~mask;
+            pending.released_buttons |= mask;
+        }
+        pending.mouse = SDL_FPoint{event.x, event.y};
+    }
+}
+
+void snapshot::on_motion(std::span<const SDL_MouseMotionEvent> events)
+{
+    for (auto const & event : events) {
+        pending.mouse = SDL_FPoint{event.x, event.y};
+        pending.motion.x += event.xrel;
+        pending.motion.y += event.yrel;
+    }
+}
+
+void snapshot::on_scroll(std::span<const SDL_MouseWheelEvent> events)
+{
+    for (auto const & event : events) {
+        pending.scroll += event.y;
+    }
+}
+
+void snapshot::on_polled()
+{
+    committed = pending;
+
+    // start the next poll from where this one left off
+    pending.previous_keys = pending.keys;
+    pending.previous_buttons = pending.buttons;
+    pending.pressed_keys.reset();
+    pending.released_keys.reset();
+    pending.pressed_buttons = 0;
+    pending.released_buttons = 0;
+    pending.motion = SDL_FPoint{0, 0};
+    pending.scroll = 0.f;
+    ++pending.frame_number;
+}
+
+}
@@ -0,0 +1,113 @@
+#include "ion/serialization/flyweight_yaml.hpp"
+#include "ion/serialization/meta_yaml.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <yaml-cpp/yaml.h>
+
+ion::yaml_flyweights::yaml_flyweights(const YAML::Node & document)
+{
+    scan(document);
+}
+
+void ion::yaml_flyweights::scan(const YAML::Node & document)
+{
+    // count how many times each node is reached, and only walk into a node the first time
+    std::unordered_map<int, std::vector<std::pair<YAML::Node, int>>> reached;
+    std::vector<YAML::Node> unvisited{ document };
+    while (not unvisited.empty())
+    {
+        const YAML::Node node = unvisited.back();
+        unvisited.pop_back();
+        if (not node) { continue; }
+
+        // nodes that were built in code have no mark to bucket them by, so rather than
+        // comparing each of them to every other, they're walked each time they're reached and
+        // never shared
+        if (not node.Mark().is_null())
+        {
+            auto & bucket = reached[node.Mark().pos];
+            const auto seen = std::ranges::find_if(bucket, [&node](const auto & other) { return other.first.is(node); });
+            if (seen != bucket.end())
+            {
+                ++seen->second;
+                continue;
+            }
+            bucket.emplace_back(node, 1);
+        }
+
+        if (node.IsMap())
+        {
+            for (const auto & elem : node) { unvisited.push_back(elem.second); }
+        }
+        else if (node.IsSequence())
+        {
+            for (const auto & elem : node) { unvisited.push_back(elem); }
+        }
+    }
+
+    for (const auto & [pos, bucket] : reached)
+    {
+        for (const auto & [node, count] : bucket)
+        {
+            if (count > 1 and not is_shared(node)) { shared_nodes[pos].push_back(node); }
+        }
+    }
+}
+
+bool ion::yaml_flyweights::is_shared(const YAML::Node & node) const
+{
+    if (not node or node.Mark().is_null()) { return false; }
+    const auto bucket = shared_nodes.find(node.Mark().pos);
+    return bucket != shared_nodes.end() and
+        std::ranges::any_of(bucket->second, [&node](const YAML::Node & shared) { return shared.is(node); });
+}
+
+std::shared_ptr<const entt::meta_any>
+ion::yaml_flyweights::decode(const YAML::Node & node, const entt::meta_type & type)
+{
+    if (not node or not type) { return nullptr; }
+    const bool shared = is_shared(node);
+    if (const auto * found = shared? find(node, type) : nullptr)
+    {
+        return found->object;
+    }
+
+    auto object = std::make_shared<entt::meta_any>(type.construct());
+    if (not *object)
+    {
+        std::printf("Couldn't decode because type isn't default constructible\n");
+        return nullptr;
+    }
+    if (not decode_node(node, *object, this)) { return nullptr; }
+
+    if (shared)
+    {
+        entries[node.Mark().pos].push_back({ node, type, object });
+        ++num_objects;
+    }
+    return object;
+}
+
+void ion::yaml_flyweights::clear()
+{
+    entries.clear();
+    num_objects = 0;
+}
+
+const ion::yaml_flyweights::entry *
+ion::yaml_flyweights::find(const YAML::Node & node, const entt::meta_type & type) const
+{
+    const auto bucket = entries.find(node.Mark().pos);
+    if (bucket == entries.end()) { return nullptr; }
+
+    for (const auto & candidate : bucket->second)
+    {
+        if (candidate.type == type and candidate.node.is(node))
+        {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
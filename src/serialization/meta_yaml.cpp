@@ -1,4 +1,5 @@
 #include "ion/serialization/meta_yaml.hpp"
+#include "ion/serialization/flyweight_yaml.hpp"
 #include <cstdio>
 #include <yaml-cpp/yaml.h>
 
@@ -129,18 +130,36 @@ bool ion::decode_scalar(const YAML::Node & node, entt::meta_any & obj)
     return false;
 }
 
-bool ion::decode_map(const YAML::Node & node, entt::meta_any & obj)
+bool ion::decode_node(const YAML::Node & node, entt::meta_any & obj, yaml_flyweights * flyweights)
+{
+    if (not node) { return false; }
+    if (node.IsScalar()) { return decode_scalar(node, obj); }
+    if (node.IsMap()) { return decode_map(node, obj, flyweights); }
+    std::printf("Failed to decode because type is neither scalar nor map (currently unsupported\n");
+    return false;
+}
+
+bool ion::decode_map(const YAML::Node & node, entt::meta_any & obj, yaml_flyweights * flyweights)
 {
     if (not node or not node.IsMap()) { return false; }
     bool success = true;
-    using as_any = YAML::convert<entt::meta_any>;
     for (const auto & elem : node)
     {
         const std::string prop_name = elem.first.Scalar();
         const auto prop_id = entt::hashed_string{ prop_name.c_str() };
         auto prop = obj.get(prop_id);
         // TODO: add base case for max recursion depth
-        success = success and as_any::decode(elem.second, prop);
+        if (flyweights and flyweights->is_shared(elem.second))
+        {
+            // an aliased value is only decoded once, and the member gets a copy of it
+            const auto shared = flyweights->decode(elem.second, prop.type());
+            if (shared) { prop = *shared; }
+            success = success and shared != nullptr;
+        }
+        else
+        {
+            success = success and decode_node(elem.second, prop, flyweights);
+        }
         obj.set(prop_id, prop);
     }
     if (success) { return true; }
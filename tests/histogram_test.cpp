@@ -0,0 +1,168 @@
+#include <ion/time/histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <source_location>
+#include <tuple>
+#include <vector>
+
+namespace {
+int num_failures = 0;
+
+void check(bool passed, char const * what, std::source_location where = std::source_location::current())
+{
+    if (not passed) {
+        std::fprintf(stderr, "%s:%u: %s\n", where.file_name(), static_cast<unsigned>(where.line()), what);
+        ++num_failures;
+    }
+}
+
+/** The exact value a fraction of the sorted values are at or below */
+std::uint64_t exact_percentile(std::vector<std::uint64_t> const & sorted, double fraction)
+{
+    const auto rank = std::max<std::size_t>(static_cast<std::size_t>(std::ceil(fraction*static_cast<double>(sorted.size()))), 1);
+    return sorted[rank - 1];
+}
+
+using bucket = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t>;
+
+std::vector<bucket> buckets_of(ion::histogram const & histogram)
+{
+    std::vector<bucket> buckets;
+    histogram.for_each_bucket([&buckets](std::uint64_t lowest, std::uint64_t highest, std::uint64_t count) {
+        buckets.emplace_back(lowest, highest, count);
+    });
+    return buckets;
+}
+
+void test_small_values_are_exact()
+{
+    ion::histogram histogram;
+    for (std::uint64_t value = 1; value <= 100; ++value) {
+        histogram.record(value);
+    }
+    check(histogram.count() == 100, "every value is counted");
+    check(histogram.min() == 1 and histogram.max() == 100, "the min and max are kept");
+    check(histogram.mean() == 50.5, "the mean is exact");
+    check(histogram.percentile(.5) == 50, "values below 2^precision_bits have their own buckets");
+    check(histogram.percentile(.99) == 99, "p99 of 1 to 100 is 99");
+    check(histogram.percentile(0.) == 1, "p0 is the smallest value");
+    check(histogram.percentile(1.) == 100, "p100 is the largest value");
+    check(histogram.percentile(2.) == 100 and histogram.percentile(-1.) == 1, "fractions are clamped");
+}
+
+void test_percentiles_are_precise()
+{
+    std::mt19937_64 rng{ 47 };
+    std::lognormal_distribution<double> frame_times{ std::log(16'000'000.), 1.5 };
+
+    ion::histogram histogram;
+    std::vector<std::uint64_t> values;
+    for (int k = 0; k < 100'000; ++k) {
+        const auto value = static_cast<std::uint64_t>(frame_times(rng));
+        histogram.record(value);
+        values.push_back(std::min(value, ion::histogram::max_value));
+    }
+    std::ranges::sort(values);
+
+    // a bucket is at most 1/2^precision_bits of the values in it wide
+    const double precision = 1./static_cast<double>(std::uint64_t{1} << ion::histogram::precision_bits);
+    for (const double fraction : { .001, .1, .5, .9, .99, .999, .9999 }) {
+        const auto exact = static_cast<double>(exact_percentile(values, fraction));
+        const auto estimate = static_cast<double>(histogram.percentile(fraction));
+        check(estimate >= exact and estimate <= exact*(1. + precision) + 1., "a percentile is within a bucket of the exact value");
+    }
+    check(histogram.min() == values.front(), "the min is exact");
+}
+
+void test_values_past_the_range()
+{
+    ion::histogram histogram;
+    const std::uint64_t huge = ion::histogram::max_value*4;
+    histogram.record(10);
+    histogram.record(huge);
+    check(histogram.max() == huge, "the true maximum is kept past the range");
+    check(histogram.percentile(1.) == huge, "the last bucket's percentile is the maximum");
+    check(histogram.percentile(.5) == 10, "values in range are unaffected");
+}
+
+void test_recording_several_times()
+{
+    ion::histogram once;
+    ion::histogram each;
+    once.record(12345, 7);
+    once.record(99, 0);
+    for (int k = 0; k < 7; ++k) {
+        each.record(12345);
+    }
+    check(once.count() == 7, "a value can be counted several times at once");
+    check(buckets_of(once) == buckets_of(each), "counting at once matches counting one by one");
+    check(once.mean() == each.mean(), "so does the mean");
+
+    ion::histogram seconds;
+    seconds.record_seconds(.016);
+    seconds.record_seconds(-1.);
+    check(seconds.max() == 16'000'000 and seconds.min() == 0, "seconds are rounded to nanoseconds, and negative ones to zero");
+}
+
+void test_merge()
+{
+    std::mt19937_64 rng{ 4747 };
+    std::uniform_int_distribution<std::uint64_t> values{ 0, 1'000'000'000 };
+
+    ion::histogram all;
+    ion::histogram first;
+    ion::histogram second;
+    for (int k = 0; k < 10'000; ++k) {
+        const std::uint64_t value = values(rng);
+        all.record(value);
+        (k%3 == 0? first : second).record(value);
+    }
+    ion::histogram merged = first;
+    merged.merge(second);
+    check(merged.count() == all.count(), "merging adds the counts");
+    check(merged.min() == all.min() and merged.max() == all.max(), "merging keeps the min and max");
+    check(std::abs(merged.mean() - all.mean()) <= 1e-6*all.mean(), "merging keeps the mean");
+    check(buckets_of(merged) == buckets_of(all), "merging adds every bucket");
+    for (const double fraction : { .25, .5, .75, .99 }) {
+        check(merged.percentile(fraction) == all.percentile(fraction), "merged percentiles match recording everything in one");
+    }
+
+    ion::histogram empty;
+    merged.merge(empty);
+    check(merged.count() == all.count() and merged.min() == all.min(), "merging an empty histogram changes nothing");
+    empty.merge(first);
+    check(empty.min() == first.min() and empty.max() == first.max(), "merging into an empty histogram copies it");
+}
+
+void test_reset()
+{
+    ion::histogram histogram;
+    histogram.record(5);
+    histogram.record(5'000'000);
+    histogram.reset();
+    check(histogram.empty() and histogram.count() == 0, "reset forgets every value");
+    check(histogram.min() == 0 and histogram.max() == 0 and histogram.mean() == 0., "an empty histogram has no min, max or mean");
+    check(histogram.percentile(.5) == 0, "an empty histogram has no percentiles");
+    check(buckets_of(histogram).empty(), "an empty histogram has no buckets");
+
+    histogram.record(300);
+    check(histogram.min() == 300 and histogram.max() == 300, "a reset histogram records like a new one");
+    check(histogram.percentile(1.) == 300, "a reset histogram's percentiles only see new values");
+}
+}
+
+int main()
+{
+    test_small_values_are_exact();
+    test_percentiles_are_precise();
+    test_values_past_the_range();
+    test_recording_several_times();
+    test_merge();
+    test_reset();
+    return num_failures == 0? EXIT_SUCCESS : EXIT_FAILURE;
+}
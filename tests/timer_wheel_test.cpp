@@ -0,0 +1,216 @@
+#include <ion/time/timer_wheel.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <source_location>
+#include <utility>
+#include <vector>
+
+namespace {
+int num_failures = 0;
+
+void check(bool passed, char const * what, std::source_location where = std::source_location::current())
+{
+    if (not passed) {
+        std::fprintf(stderr, "%s:%u: %s\n", where.file_name(), static_cast<unsigned>(where.line()), what);
+        ++num_failures;
+    }
+}
+
+template<typename Payload>
+std::uint64_t ticks_of(ion::timer_wheel<Payload> const & wheel)
+{
+    return static_cast<std::uint64_t>(std::llround(wheel.now()/wheel.resolution()));
+}
+
+void test_one_shot()
+{
+    ion::timer_wheel<int> wheel{ .001 };
+    std::vector<int> ready;
+    wheel.schedule(.005, 1);
+    check(wheel.size() == 1, "a scheduled timer is counted");
+    check(wheel.advance(.004, ready) == 0 and ready.empty(), "a timer isn't due early");
+    check(wheel.advance(.001, ready) == 1 and ready == std::vector{ 1 }, "a timer is due on its tick");
+    check(wheel.empty(), "a one shot timer is done once it's due");
+    check(wheel.advance(1., ready) == 0, "a one shot timer is only due once");
+
+    // time that's less than a tick adds up
+    wheel.schedule(.001, 2);
+    for (int k = 0; k < 3; ++k) {
+        wheel.advance(.0003, ready);
+    }
+    check(ready.size() == 1, "partial ticks aren't a tick");
+    wheel.advance(.0003, ready);
+    check(ready.size() == 2, "partial ticks add up to a tick");
+
+    wheel.schedule(0., 3);
+    check(wheel.advance(.001, ready) == 1, "a timer with no delay is due on the next tick");
+}
+
+void test_cascade_across_levels()
+{
+    // delays that start out in each of the four wheels, and one past all of them
+    const std::vector<std::uint64_t> delays{
+        1, 255, 256, 257, 300, 65'535, 65'536, 70'000, 16'777'215, 16'777'216, 20'000'000,
+        4'294'967'295, 4'294'967'296, 5'000'000'000
+    };
+    ion::timer_wheel<std::size_t> wheel{ 1. };
+    for (std::size_t k = 0; k < delays.size(); ++k) {
+        wheel.schedule(static_cast<double>(delays[k]), k);
+    }
+    std::vector<std::uint64_t> fired_at(delays.size(), 0);
+    std::vector<int> times_fired(delays.size(), 0);
+    const std::size_t num_fired = wheel.advance(6e9, [&](std::size_t k) {
+        fired_at[k] = ticks_of(wheel);
+        ++times_fired[k];
+    });
+    check(num_fired == delays.size(), "every timer is due");
+    for (std::size_t k = 0; k < delays.size(); ++k) {
+        check(times_fired[k] == 1 and fired_at[k] == delays[k], "each timer falls through the wheels to its own tick");
+    }
+}
+
+void test_cascade_in_small_steps()
+{
+    std::mt19937_64 rng{ 48 };
+    std::uniform_int_distribution<std::uint64_t> delays{ 1, 200'000 };
+    std::uniform_int_distribution<int> steps{ 1, 700 };
+
+    ion::timer_wheel<std::size_t> wheel{ .001 };
+    std::vector<std::uint64_t> due_at;
+    for (std::size_t k = 0; k < 5000; ++k) {
+        due_at.push_back(delays(rng));
+        wheel.schedule(static_cast<double>(due_at.back())*.001, k);
+    }
+    std::vector<std::uint64_t> fired_at(due_at.size(), 0);
+    std::vector<int> times_fired(due_at.size(), 0);
+    while (not wheel.empty()) {
+        wheel.advance(static_cast<double>(steps(rng))*.001, [&](std::size_t k) {
+            fired_at[k] = ticks_of(wheel);
+            ++times_fired[k];
+        });
+    }
+    bool is_each_on_time = true;
+    for (std::size_t k = 0; k < due_at.size(); ++k) {
+        is_each_on_time = is_each_on_time and times_fired[k] == 1 and fired_at[k] == due_at[k];
+    }
+    check(is_each_on_time, "timers advanced a few ticks at a time are each due once, on their own tick");
+}
+
+void test_cancel()
+{
+    ion::timer_wheel<int> wheel{ .001 };
+    std::vector<int> ready;
+    const ion::timer_id near = wheel.schedule(.010, 1);
+    const ion::timer_id far = wheel.schedule(100., 2);
+    wheel.schedule(.010, 3);
+    check(wheel.cancel(near) and wheel.cancel(far), "scheduled timers can be cancelled");
+    check(not wheel.is_scheduled(near) and not wheel.is_scheduled(far), "cancelled timers aren't scheduled");
+    check(not wheel.cancel(near), "a timer can only be cancelled once");
+    check(wheel.size() == 1, "cancelled timers aren't counted");
+    wheel.advance(200., ready);
+    check(ready == std::vector{ 3 }, "cancelled timers are never due");
+
+    // a finished timer's id doesn't cancel the timer that reuses its place
+    const ion::timer_id reused = wheel.schedule(.001, 4);
+    check(not wheel.cancel(near), "an old id doesn't cancel a new timer");
+    check(wheel.is_scheduled(reused), "the new timer is still scheduled");
+
+    // timers due on the same tick can cancel each other while they're being fired
+    ion::timer_wheel<std::function<void()>> firing{ .001 };
+    int num_called = 0;
+    ion::timer_id first;
+    ion::timer_id second;
+    first = firing.schedule(.002, [&] { ++num_called; firing.cancel(second); });
+    second = firing.schedule(.002, [&] { ++num_called; firing.cancel(first); });
+    check(firing.advance(.002) == 1 and num_called == 1, "a timer cancelled while firing isn't fired");
+    check(firing.empty(), "a timer cancelled while firing isn't counted");
+
+    wheel.schedule(.5, 5);
+    wheel.clear();
+    check(wheel.empty() and wheel.advance(1., ready) == 0, "clear cancels every timer");
+}
+
+void test_repeating()
+{
+    ion::timer_wheel<std::function<void()>> wheel{ .001 };
+    std::vector<std::uint64_t> fired_at;
+    const ion::timer_id repeating = wheel.schedule(.005, [&] { fired_at.push_back(ticks_of(wheel)); }, .010);
+    check(wheel.advance(.100) == 10, "a repeating timer is due every period");
+    check(fired_at == std::vector<std::uint64_t>{ 5, 15, 25, 35, 45, 55, 65, 75, 85, 95 }, "a repeating timer keeps to its period");
+    check(wheel.is_scheduled(repeating) and wheel.size() == 1, "a repeating timer stays scheduled");
+    check(wheel.cancel(repeating) and wheel.advance(.100) == 0, "a repeating timer can be cancelled");
+
+    // a repeating timer that cancels itself stops
+    int num_called = 0;
+    ion::timer_id self;
+    self = wheel.schedule(.001, [&] {
+        if (++num_called == 3) {
+            wheel.cancel(self);
+        }
+    }, .001);
+    wheel.advance(.010);
+    check(num_called == 3 and wheel.empty(), "a repeating timer can cancel itself");
+
+    // a long period is due on the right tick once it has fallen back down the wheels
+    std::vector<std::uint64_t> slow;
+    const std::uint64_t start = ticks_of(wheel);
+    wheel.schedule(70., [&] { slow.push_back(ticks_of(wheel) - start); }, 70.);
+    wheel.advance(211.);
+    check(slow == std::vector<std::uint64_t>{ 70'000, 140'000, 210'000 }, "long periods cascade back down to their tick");
+
+    // firing can schedule more timers, which are due no sooner than the next tick
+    ion::timer_wheel<std::function<void()>> chained{ .001 };
+    int num_chained = 0;
+    chained.schedule(.001, [&] {
+        ++num_chained;
+        chained.schedule(0., [&] { ++num_chained; });
+    });
+    check(chained.advance(.001) == 1 and num_chained == 1, "a timer scheduled while firing isn't due on the same tick");
+    check(chained.advance(.001) == 1 and num_chained == 2, "a timer scheduled while firing is due on the next tick");
+}
+
+void test_copy_and_move()
+{
+    auto original = std::make_unique<ion::timer_wheel<int>>(.001);
+    std::vector<ion::timer_id> ids;
+    for (int k = 0; k < 100; ++k) {
+        ids.push_back(original->schedule(.001*(k*37%300 + 1), k));
+    }
+    ion::timer_wheel<int> copied = *original;
+
+    // the copy can't lean on the original once it's gone
+    original.reset();
+    int num_cancelled = 0;
+    for (std::size_t k = 0; k < ids.size(); k += 2) {
+        num_cancelled += copied.cancel(ids[k]);
+    }
+    check(num_cancelled == 50 and copied.size() == 50, "a copied wheel's timers can be cancelled");
+
+    std::vector<int> fired;
+    copied.advance(.150, fired);
+    ion::timer_wheel<int> moved = std::move(copied);
+    moved.advance(1., fired);
+    bool is_each_odd = true;
+    for (const int k : fired) {
+        is_each_odd = is_each_odd and k%2 == 1;
+    }
+    check(fired.size() == 50 and is_each_odd and moved.empty(), "a copied and moved wheel fires the timers it kept");
+}
+}
+
+int main()
+{
+    test_one_shot();
+    test_cascade_across_levels();
+    test_cascade_in_small_steps();
+    test_cancel();
+    test_repeating();
+    test_copy_and_move();
+    return num_failures == 0? EXIT_SUCCESS : EXIT_FAILURE;
+}
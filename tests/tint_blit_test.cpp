@@ -0,0 +1,248 @@
+#include <ion/engine/tint_blit.hpp>
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_surface.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+namespace
+{
+using surface_ptr = std::unique_ptr<SDL_Surface, decltype(&SDL_DestroySurface)>;
+
+/** A source format and a destination format that tint_blit can blit between */
+struct format_pair
+{
+    SDL_PixelFormat source;
+    SDL_PixelFormat destination;
+};
+
+constexpr std::array format_pairs{
+    format_pair{ SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_XRGB8888 },
+    format_pair{ SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XRGB8888 },
+    format_pair{ SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_XBGR8888 },
+    format_pair{ SDL_PIXELFORMAT_XBGR8888, SDL_PIXELFORMAT_XBGR8888 }
+};
+
+constexpr std::array kernels{
+    ion::tint_blit_kernel::scalar,
+    ion::tint_blit_kernel::sse2,
+    ion::tint_blit_kernel::avx2
+};
+
+const char * kernel_name(ion::tint_blit_kernel kernel)
+{
+    switch (kernel)
+    {
+    case ion::tint_blit_kernel::scalar: return "scalar";
+    case ion::tint_blit_kernel::sse2: return "sse2";
+    case ion::tint_blit_kernel::avx2: return "avx2";
+    default: return "automatic";
+    }
+}
+
+std::uint32_t & pixel_at(SDL_Surface * surface, int x, int y)
+{
+    return reinterpret_cast<std::uint32_t *>(static_cast<std::uint8_t *>(surface->pixels) + y*surface->pitch)[x];
+}
+
+SDL_Color random_color(std::mt19937 & rng)
+{
+    std::uniform_int_distribution<int> channel{ 0, 255 };
+    return SDL_Color{ static_cast<Uint8>(channel(rng)), static_cast<Uint8>(channel(rng)),
+                      static_cast<Uint8>(channel(rng)), static_cast<Uint8>(channel(rng)) };
+}
+
+/** One randomized blit, with the surfaces it starts from */
+struct blit_case
+{
+    surface_ptr source{ nullptr, &SDL_DestroySurface };
+    surface_ptr destination{ nullptr, &SDL_DestroySurface };
+    SDL_Rect rect;
+    SDL_Rect clip;
+    SDL_Color fill;
+    SDL_Color modulate;
+    bool has_color_key;
+    std::uint32_t color_key;
+};
+
+blit_case make_case(std::mt19937 & rng, const format_pair & formats)
+{
+    std::uniform_int_distribution<int> size{ 1, 48 };
+    std::uniform_int_distribution<std::uint32_t> bits;
+    std::bernoulli_distribution coin;
+
+    blit_case made;
+    made.rect.w = size(rng);
+    made.rect.h = size(rng);
+    made.source.reset(SDL_CreateSurface(made.rect.w, made.rect.h, formats.source));
+    made.destination.reset(SDL_CreateSurface(size(rng) + 8, size(rng) + 8, formats.destination));
+    if (not made.source or not made.destination) { return made; }
+
+    // the rect may hang off any side of the destination, and the clip may cut into it anywhere
+    auto * destination = made.destination.get();
+    made.rect.x = std::uniform_int_distribution<int>{ -made.rect.w + 1, destination->w - 1 }(rng);
+    made.rect.y = std::uniform_int_distribution<int>{ -made.rect.h + 1, destination->h - 1 }(rng);
+    made.clip.x = std::uniform_int_distribution<int>{ 0, destination->w - 1 }(rng);
+    made.clip.y = std::uniform_int_distribution<int>{ 0, destination->h - 1 }(rng);
+    made.clip.w = std::uniform_int_distribution<int>{ 1, destination->w - made.clip.x }(rng);
+    made.clip.h = std::uniform_int_distribution<int>{ 1, destination->h - made.clip.y }(rng);
+    if (coin(rng)) { made.clip = SDL_Rect{ 0, 0, destination->w, destination->h }; }
+
+    for (int y = 0; y < destination->h; ++y)
+    {
+        for (int x = 0; x < destination->w; ++x) { pixel_at(destination, x, y) = bits(rng); }
+    }
+
+    // alpha is mostly fully transparent or opaque in real images, so those get extra weight
+    auto * source = made.source.get();
+    std::uniform_int_distribution<int> alpha_kind{ 0, 3 };
+    for (int y = 0; y < source->h; ++y)
+    {
+        for (int x = 0; x < source->w; ++x)
+        {
+            const SDL_Color color = random_color(rng);
+            const int kind = alpha_kind(rng);
+            const Uint8 alpha = kind == 0? 0x00 : kind == 1? 0xff : color.a;
+            pixel_at(source, x, y) = SDL_MapSurfaceRGBA(source, color.r, color.g, color.b, alpha);
+        }
+    }
+
+    // key one of the source's colors, and scatter it around with other alphas
+    made.has_color_key = coin(rng);
+    if (made.has_color_key)
+    {
+        made.color_key = pixel_at(source, 0, 0);
+        std::uniform_int_distribution<int> column{ 0, source->w - 1 };
+        std::uniform_int_distribution<int> row{ 0, source->h - 1 };
+        const SDL_PixelFormatDetails * details = SDL_GetPixelFormatDetails(source->format);
+        for (int k = 0; k < source->w*source->h/4; ++k)
+        {
+            pixel_at(source, column(rng), row(rng)) = (made.color_key & ~details->Amask) | (bits(rng) & details->Amask);
+        }
+        SDL_SetSurfaceColorKey(source, true, made.color_key);
+    }
+
+    made.fill = random_color(rng);
+    made.modulate = random_color(rng);
+    if (coin(rng)) { made.modulate = SDL_Color{ 0xff, 0xff, 0xff, 0xff }; }
+    return made;
+}
+
+/** What sdl draws by filling the rect and then blending the source over it */
+surface_ptr two_pass(const blit_case & blit)
+{
+    surface_ptr expected{ SDL_DuplicateSurface(blit.destination.get()), &SDL_DestroySurface };
+    if (not expected) { return expected; }
+
+    SDL_SetSurfaceClipRect(expected.get(), &blit.clip);
+    const std::uint32_t fill = SDL_MapSurfaceRGBA(expected.get(), blit.fill.r, blit.fill.g, blit.fill.b, 0xff);
+    SDL_FillSurfaceRect(expected.get(), &blit.rect, fill);
+
+    SDL_Surface * source = blit.source.get();
+    SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceColorMod(source, blit.modulate.r, blit.modulate.g, blit.modulate.b);
+    SDL_SetSurfaceAlphaMod(source, blit.modulate.a);
+    SDL_Rect rect = blit.rect;
+    SDL_BlitSurface(source, nullptr, expected.get(), &rect);
+    return expected;
+}
+
+/**
+ * Compare what a kernel drew to what sdl drew
+ *
+ * Inside the blit, the color channels have to match sdl's and the unused bits have to be the
+ * fill's. Everything else has to be left as it was.
+ */
+bool matches(const blit_case & blit, SDL_Surface * drawn, SDL_Surface * expected, ion::tint_blit_kernel kernel)
+{
+    const SDL_PixelFormatDetails * details = SDL_GetPixelFormatDetails(drawn->format);
+    const std::uint32_t color_mask = details->Rmask | details->Gmask | details->Bmask;
+    const std::uint32_t fill = SDL_MapSurfaceRGBA(drawn, blit.fill.r, blit.fill.g, blit.fill.b, 0xff);
+
+    SDL_Rect area;
+    const bool has_area = SDL_GetRectIntersection(&blit.rect, &blit.clip, &area);
+    for (int y = 0; y < drawn->h; ++y)
+    {
+        for (int x = 0; x < drawn->w; ++x)
+        {
+            const SDL_Point point{ x, y };
+            const std::uint32_t actual = pixel_at(drawn, x, y);
+            const std::uint32_t wanted = pixel_at(expected, x, y);
+            const bool is_inside = has_area and SDL_PointInRect(&point, &area);
+            const bool is_same = is_inside
+                ? (actual & color_mask) == (wanted & color_mask) and (actual & ~color_mask) == (fill & ~color_mask)
+                : actual == wanted;
+            if (not is_same)
+            {
+                SDL_Log("The %s kernel drew %08x at %d, %d of %s where sdl drew %08x "
+                        "(rect %d, %d, %dx%d, clip %d, %d, %dx%d, fill %02x%02x%02x, modulate %02x%02x%02x%02x, %s)\n",
+                        kernel_name(kernel), actual, x, y, SDL_GetPixelFormatName(drawn->format), wanted,
+                        blit.rect.x, blit.rect.y, blit.rect.w, blit.rect.h,
+                        blit.clip.x, blit.clip.y, blit.clip.w, blit.clip.h,
+                        blit.fill.r, blit.fill.g, blit.fill.b,
+                        blit.modulate.r, blit.modulate.g, blit.modulate.b, blit.modulate.a,
+                        blit.has_color_key? "color keyed" : "not color keyed");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+}
+
+int main()
+{
+    constexpr int num_cases = 2000;
+    std::mt19937 rng{ 0x10b11e7u };
+
+    int num_blits = 0;
+    int num_failures = 0;
+    for (int k = 0; k < num_cases; ++k)
+    {
+        const format_pair & formats = format_pairs[static_cast<std::size_t>(k) % format_pairs.size()];
+        const blit_case blit = make_case(rng, formats);
+        const surface_ptr expected = two_pass(blit);
+        if (not blit.source or not blit.destination or not expected)
+        {
+            SDL_Log("Couldn't create the surfaces to blit: %s\n", SDL_GetError());
+            return EXIT_FAILURE;
+        }
+
+        for (const auto kernel : kernels)
+        {
+            if (not ion::use_tint_blit_kernel(kernel)) { continue; }
+            ++num_blits;
+
+            const surface_ptr drawn{ SDL_DuplicateSurface(blit.destination.get()), &SDL_DestroySurface };
+            SDL_SetSurfaceClipRect(drawn.get(), &blit.clip);
+            if (not ion::tint_blit(blit.source.get(), drawn.get(), blit.rect, blit.fill, blit.modulate))
+            {
+                SDL_Log("The %s kernel couldn't blit from %s to %s\n", kernel_name(kernel),
+                        SDL_GetPixelFormatName(formats.source), SDL_GetPixelFormatName(formats.destination));
+                ++num_failures;
+                continue;
+            }
+            if (not matches(blit, drawn.get(), expected.get(), kernel)) { ++num_failures; }
+        }
+    }
+
+    for (const auto kernel : kernels)
+    {
+        if (not ion::use_tint_blit_kernel(kernel))
+        {
+            SDL_Log("Skipped the %s kernel, which this cpu doesn't support\n", kernel_name(kernel));
+        }
+    }
+    ion::use_tint_blit_kernel(ion::tint_blit_kernel::automatic);
+
+    if (num_failures > 0)
+    {
+        SDL_Log("%d of %d blits didn't match sdl\n", num_failures, num_blits);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}